@@ -1,42 +1,143 @@
+#include "matrix_generator.h"
+#include "numa_placement.h"
 #include <iostream>
 #include <fstream>
-#include <random>
-#include <iomanip>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
 
-int main() {
+static void print_usage() {
+    std::cout << "Usage: generate_matrices [options]\n"
+              << "  (no options)          Uniform [-10, 10] 100x100, 500x500, 1000x1000 into data/\n"
+              << "  --type T              uniform | gaussian | cond | spectrum | eigen |\n"
+              << "                        symmetric | banded | rank\n"
+              << "  --rows M --cols N     Dimensions (--n N sets both)\n"
+              << "  --seed S              RNG seed (default 42)\n"
+              << "  --min A --max B       Entry range for uniform/symmetric (default -10, 10)\n"
+              << "  --cond C              Condition number for cond (default 1e6)\n"
+              << "  --values FILE         Singular values (spectrum) or eigenvalues (eigen)\n"
+              << "  --lower KL --upper KU Bandwidths for banded (default 1, 1)\n"
+              << "  --rank R              Rank for rank (default N/2)\n"
+              << "  --reflectors K        Householder factors for random orthogonal (0 = Haar)\n"
+              << "  --format F            text | binary (default text)\n"
+              << "  --precision P         Significant digits for text output, 1-17 (default 17)\n"
+              << "  --out PATH            Output file\n";
+}
+
+static std::vector<double> read_values(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) throw std::runtime_error("Cannot open file: " + path);
+    std::vector<double> values;
+    double x;
+    while (file >> x) values.push_back(x);
+    if (values.empty()) throw std::runtime_error("No values in " + path);
+    return values;
+}
+
+// Original behaviour: sample matrices for the benchmark with 6 decimals, now reproducible
+static int generate_defaults() {
     const int sizes[] = {100, 500, 1000};
     const double min_val = -10.0;
     const double max_val = 10.0;
     const std::string data_dir = "data";  // Your existing data folder
-    
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<double> dist(min_val, max_val);
-    
+
     for (int n : sizes) {
         std::string filename = data_dir + "/matrix_" + std::to_string(n) + "x" + std::to_string(n) + ".txt";
-        std::ofstream file(filename);
-        
-        if (!file) {
+        try {
+            MatrixGenerator::write_text(MatrixGenerator::uniform(n, n, min_val, max_val, n), filename, 6, true);
+        } catch (const std::exception&) {
             std::cerr << "Error: Could not create file " << filename << "\n";
             std::cerr << "Make sure the 'data' directory exists in the current path.\n";
             continue;
         }
-        
-        file << std::fixed << std::setprecision(6);
-        
-        for (int i = 0; i < n; ++i) {
-            for (int j = 0; j < n; ++j) {
-                file << dist(gen);
-                if (j < n-1) file << " ";
-            }
-            file << "\n";
-        }
-        
         std::cout << "Generated " << filename << " (" << n << "x" << n << ")\n";
     }
-    
+
     std::cout << "\nMatrix generation complete. Files saved to /data folder.\n";
     return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char* argv[]) {
+    Numa::pin_threads();
+    if (argc == 1) return generate_defaults();
+
+    std::string type = "uniform", format = "text", out, values_path;
+    int rows = 0, cols = 0, lower = 1, upper = 1, rank = -1, reflectors = 0, precision = 17;
+    double min_val = -10.0, max_val = 10.0, cond = 1e6;
+    unsigned long long seed = 42;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                print_usage();
+                return 0;
+            }
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+            const std::string val = argv[++i];
+
+            if (arg == "--type") type = val;
+            else if (arg == "--rows") rows = std::stoi(val);
+            else if (arg == "--cols") cols = std::stoi(val);
+            else if (arg == "--n") rows = cols = std::stoi(val);
+            else if (arg == "--seed") seed = std::stoull(val);
+            else if (arg == "--min") min_val = std::stod(val);
+            else if (arg == "--max") max_val = std::stod(val);
+            else if (arg == "--cond") cond = std::stod(val);
+            else if (arg == "--values") values_path = val;
+            else if (arg == "--lower") lower = std::stoi(val);
+            else if (arg == "--upper") upper = std::stoi(val);
+            else if (arg == "--rank") rank = std::stoi(val);
+            else if (arg == "--reflectors") reflectors = std::stoi(val);
+            else if (arg == "--format") format = val;
+            else if (arg == "--precision") precision = std::max(1, std::min(17, std::stoi(val)));
+            else if (arg == "--out") out = val;
+            else throw std::invalid_argument("Unknown option " + arg);
+        }
+
+        if (format != "text" && format != "binary")
+            throw std::invalid_argument("Format must be text or binary");
+
+        std::vector<double> values;
+        if (type == "spectrum" || type == "eigen") {
+            if (values_path.empty()) throw std::invalid_argument("--values is required for " + type);
+            values = read_values(values_path);
+            rows = cols = values.size();
+        }
+        if (rows <= 0 || cols <= 0)
+            throw std::invalid_argument("Dimensions must be positive integers");
+
+        const bool square = rows == cols;
+        if (!square && type != "uniform" && type != "gaussian" && type != "rank")
+            throw std::invalid_argument("Type " + type + " requires a square matrix");
+
+        Matrix A(1, 1);
+        if (type == "uniform") A = MatrixGenerator::uniform(rows, cols, min_val, max_val, seed);
+        else if (type == "gaussian") A = MatrixGenerator::gaussian(rows, cols, seed);
+        else if (type == "cond") A = MatrixGenerator::with_condition(rows, cond, seed, reflectors);
+        else if (type == "spectrum") A = MatrixGenerator::with_singular_values(values, seed, reflectors);
+        else if (type == "eigen") A = MatrixGenerator::with_eigenvalues(values, seed, reflectors);
+        else if (type == "symmetric") A = MatrixGenerator::symmetric(rows, min_val, max_val, seed);
+        else if (type == "banded") A = MatrixGenerator::banded(rows, lower, upper, seed);
+        else if (type == "rank")
+            A = MatrixGenerator::rank_deficient(rows, cols, rank >= 0 ? rank : std::min(rows, cols) / 2, seed);
+        else throw std::invalid_argument("Unknown matrix type " + type);
+
+        if (out.empty()) {
+            out = "data/" + type + "_" + std::to_string(rows) + "x" + std::to_string(cols) +
+                  (format == "binary" ? ".bin" : ".txt");
+        }
+
+        if (format == "binary") MatrixGenerator::write_binary(A, out);
+        else MatrixGenerator::write_text(A, out, precision);
+
+        std::cout << "Generated " << out << " (" << rows << "x" << cols << ", " << type
+                  << ", seed " << seed << ")\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        print_usage();
+        return 1;
+    }
+    return 0;
+}
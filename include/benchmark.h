@@ -1,12 +1,19 @@
 #pragma once
+#include "randomized_qr.h"
 #include <functional>  
 #include <vector>
 
 class Benchmark {
 public:
     static void run();
+    static void run_randomized();
+    static void run_solve();
+    static void run_numa();
     
 private:
     static void test_dimension(int n);
+    static void test_randomized(int n, int rank, const RandomizedQROptions& opts, const char* mode);
+    static void test_solve(int n);
+    static double triad_bandwidth();
     static double measure_cpu_time(std::function<void()> func); 
 };
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <iosfwd>
+
+// Vector kernels used by the hot loops. src/kernels_impl.cpp is compiled once
+// per instruction set and the best variant is picked at startup via CPUID.
+// Keep this header free of heavy includes: it is part of the ISA-specific objects.
+struct KernelTable {
+    const char* name;
+
+    // xᵀy
+    double (*dot)(const double* x, const double* y, int n);
+
+    // y += alpha * x
+    void (*axpy)(int n, double alpha, const double* x, double* y);
+
+    // Σ|x_i|
+    double (*sum_abs)(const double* x, int n);
+
+    // max |x_i|
+    double (*max_abs)(const double* x, int n);
+
+    // c(0:n) += alpha * Σ_{p<k} a(p) * B(p, 0:n), B row-major with stride ldb
+    void (*row_gemm)(int k, int n, double alpha, const double* a,
+                     const double* B, size_t ldb, double* c);
+};
+
+class Kernels {
+public:
+    // Active kernel set; chosen on first use, QR_KERNELS=sse2|avx2|avx512 overrides
+    static const KernelTable& get();
+
+    // Print the active and supported kernel sets
+    static void report(std::ostream& os);
+
+private:
+    static const KernelTable* select();
+};
@@ -4,40 +4,50 @@
 #include <stdexcept>
 #include <fstream>
 #include <random>
+#include "numa_placement.h"
 
 class Matrix {
 public:
     // Constructors
     Matrix(int rows, int cols, double init_val = 0.0);
     Matrix(const std::vector<std::vector<double>>& data);
+    Matrix(const Matrix& other);  // Parallel copy, pages placed per Numa policy
+    Matrix(Matrix&& other) = default;
+    Matrix& operator=(const Matrix& other);
+    Matrix& operator=(Matrix&& other) = default;
     
     // Accessors
     double& operator()(int i, int j);
     const double& operator()(int i, int j) const;
     int rows() const noexcept { return m_rows; }
     int cols() const noexcept { return m_cols; }
+    double* data() noexcept { return m_data.data(); }  // Row-major, unchecked
+    const double* data() const noexcept { return m_data.data(); }
 
     // Core operations
     Matrix operator-(const Matrix& other) const;
     Matrix operator*(const Matrix& other) const;
     Matrix transpose() const;
     Matrix inverse() const;  // For square matrices only
+    Matrix lu_solve(const Matrix& B) const;  // Solve AX = B, square A only
     
     // Norm calculations
     double normInf() const noexcept;  // Infinity norm (max row sum)
 
     // Factory methods
     static Matrix identity(int n);
-    static Matrix random(int rows, int cols, double min = -1.0, double max = 1.0);
+    static Matrix random(int rows, int cols, double min = -1.0, double max = 1.0,
+                         unsigned long long seed = 42);  // Reproducible for a given seed
     static Matrix loadFromFile(const std::string& path);
+    static Matrix loadFromBinaryFile(const std::string& path);
 
     // Utility
     void print(const std::string& label = "") const;
 
 private:
     int m_rows, m_cols;
-    std::vector<double> m_data;  // Row-major contiguous storage
+    NumaVector m_data;  // Row-major contiguous storage, NUMA-placed
 
-    // Helper for inverse()
+    // Helper for inverse() and lu_solve()
     void lu_decompose(std::vector<int>& perm, int& sign);
 };
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+#include "matrix.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Reproducible test-matrix generator. Entries come from a counter-based RNG
+// keyed by the seed, so output is identical for any thread count.
+class MatrixGenerator {
+public:
+    // Entries uniform in [min, max)
+    static Matrix uniform(int rows, int cols, double min, double max, uint64_t seed);
+
+    // Entries i.i.d. N(0, 1)
+    static Matrix gaussian(int rows, int cols, uint64_t seed);
+
+    // Random orthogonal n×n matrix; Haar-distributed when reflectors = 0
+    static Matrix orthogonal(int n, uint64_t seed, int reflectors = 0);
+
+    // U diag(sigma) Vᵀ with random orthogonal U, V
+    static Matrix with_singular_values(const std::vector<double>& sigma, uint64_t seed,
+                                       int reflectors = 0);
+
+    // Singular values geometrically spaced from 1 down to 1/cond
+    static Matrix with_condition(int n, double cond, uint64_t seed, int reflectors = 0);
+
+    // Q diag(lambda) Qᵀ with random orthogonal Q
+    static Matrix with_eigenvalues(const std::vector<double>& lambda, uint64_t seed,
+                                   int reflectors = 0);
+
+    // Symmetric matrix with entries uniform in [min, max)
+    static Matrix symmetric(int n, double min, double max, uint64_t seed);
+
+    // Uniform [-1, 1) entries inside the band -lower <= j - i <= upper, zero outside
+    static Matrix banded(int n, int lower, int upper, uint64_t seed);
+
+    // m×n matrix of exact rank `rank`: singular values 1 (first `rank`), 0 elsewhere
+    static Matrix rank_deficient(int m, int n, int rank, uint64_t seed);
+
+    // Text output compatible with Matrix::loadFromFile: precision significant
+    // digits (%g), or digits after the decimal point when fixed is set (%f)
+    static void write_text(const Matrix& A, const std::string& path, int precision = 17,
+                           bool fixed = false);
+
+    // Binary output compatible with Matrix::loadFromBinaryFile
+    static void write_binary(const Matrix& A, const std::string& path);
+
+private:
+    // A = QA (left) or A = AQᵀ (right) for the orthogonal Q drawn from (seed, stream)
+    static void apply_orthogonal(Matrix& A, uint64_t seed, uint32_t stream, bool left,
+                                 int reflectors);
+};
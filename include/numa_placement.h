@@ -0,0 +1,162 @@
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <iosfwd>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Page placement for Matrix storage
+enum class NumaPolicy {
+    Serial,      // Single-threaded zero fill: every page lands on one node
+    FirstTouch,  // Parallel fill; each row tile lands on the node of its owner thread
+    Interleave,  // Pages round-robin over all nodes (libnuma)
+    Bind         // All pages on one node (libnuma)
+};
+
+// NUMA placement and thread affinity. Rows are split into tiles of
+// tile_rows; tile b belongs to thread b % T. Parallel row loops use
+// schedule(static, Numa::tile_rows) so they touch memory the same way
+// Matrix first-touched it.
+class Numa {
+public:
+    static const int tile_rows = 64;
+
+    // Active policy; initialized from QR_NUMA=serial|firsttouch|interleave|bind[:node]
+    static NumaPolicy policy();
+    static int bind_node();
+    static void set_policy(NumaPolicy policy, int node = 0);
+
+    // Topology
+    static bool libnuma_available();
+    static std::vector<int> memory_nodes();  // Allowed nodes with memory, ascending
+    static int node_count();                 // memory_nodes().size()
+
+    // Fill/copy rows×cols storage according to the active policy
+    static void fill(double* data, int rows, int cols, double value);
+    static void copy(double* dst, const double* src, int rows, int cols);
+
+    // Large blocks: fresh mmap'd pages with Interleave/Bind applied before the
+    // first touch. Never recycled heap memory, so the policy cannot leak.
+    static const size_t large_block = size_t(1) << 20;
+    static void* allocate_pages(size_t bytes);
+    static void free_pages(void* p, size_t bytes) noexcept;
+
+    // Call f(r0, r1) for each tile-aligned row range in [begin, end), in parallel,
+    // on the thread that owns the tile
+    template <typename F>
+    static void for_each_tile(int begin, int end, F f);
+
+    // Call f(r0, r1, chunk) for every tile-aligned row range in [begin, end) and
+    // chunk in [0, chunks). Each thread first takes the chunks of its own tiles,
+    // then helps with chunks still unclaimed on other tiles, so all threads stay
+    // busy even when there are fewer tiles than threads
+    template <typename F>
+    static void for_each_tile_chunk(int begin, int end, int chunks, F f);
+
+    // Thread count and pinning: one thread per physical core, alternating between
+    // nodes; SMT siblings are used only once every core has a thread
+    static void set_threads(int threads);
+    static void pin_threads();
+    static int thread_id();
+    static int thread_count();  // Threads in the current parallel region
+    static int max_threads();   // Threads a new parallel region will use
+
+    static void report(std::ostream& os);
+};
+
+template <typename F>
+void Numa::for_each_tile(int begin, int end, F f) {
+    if (begin >= end) return;
+    const int first = begin / tile_rows;
+    const int last = (end - 1) / tile_rows;
+
+    #pragma omp parallel
+    {
+        const int t = thread_id();
+        const int T = thread_count();
+
+        // Tile b is owned by thread b % T
+        int b = first + ((t - first % T) + T) % T;
+        for (; b <= last; b += T) {
+            const int r0 = (b * tile_rows > begin) ? b * tile_rows : begin;
+            const int r1 = ((b + 1) * tile_rows < end) ? (b + 1) * tile_rows : end;
+            f(r0, r1);
+        }
+    }
+}
+
+template <typename F>
+void Numa::for_each_tile_chunk(int begin, int end, int chunks, F f) {
+    if (begin >= end || chunks <= 0) return;
+    const int first = begin / tile_rows;
+    const int tiles = (end - 1) / tile_rows - first + 1;
+    std::vector<int> next(tiles, 0);  // Next unclaimed chunk of each tile
+
+    #pragma omp parallel
+    {
+        const int t = thread_id();
+        const int T = thread_count();
+
+        // Pass 0: own tiles (b % T == t); pass 1: any tile, starting at a
+        // per-thread offset to spread out the helpers
+        for (int pass = 0; pass < 2; ++pass) {
+            for (int k = 0; k < tiles; ++k) {
+                const int idx = (pass == 0) ? k : (k + t * tiles / T) % tiles;
+                const int b = first + idx;
+                if (pass == 0 && b % T != t) continue;
+
+                const int r0 = (b * tile_rows > begin) ? b * tile_rows : begin;
+                const int r1 = ((b + 1) * tile_rows < end) ? (b + 1) * tile_rows : end;
+                for (;;) {
+                    int cb;
+                    #pragma omp atomic capture
+                    cb = next[idx]++;
+                    if (cb >= chunks) break;
+                    f(r0, r1, cb);
+                }
+            }
+        }
+    }
+}
+
+// Allocator that leaves doubles uninitialized (Numa::fill places the pages)
+// and takes large blocks from Numa::allocate_pages
+template <typename T>
+struct NumaAllocator {
+    typedef T value_type;
+
+    NumaAllocator() noexcept {}
+    template <typename U>
+    NumaAllocator(const NumaAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        const size_t bytes = n * sizeof(T);
+        if (bytes >= Numa::large_block) return static_cast<T*>(Numa::allocate_pages(bytes));
+        void* p = nullptr;
+        if (posix_memalign(&p, 64, bytes ? bytes : 64) != 0) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        const size_t bytes = n * sizeof(T);
+        if (bytes >= Numa::large_block) Numa::free_pages(p, bytes);
+        else free(p);
+    }
+
+    // Default-initialize: no zero fill, so the first touch happens in Numa::fill
+    template <typename U>
+    void construct(U* p) { ::new (static_cast<void*>(p)) U; }
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) { ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+
+    template <typename U>
+    struct rebind { typedef NumaAllocator<U> other; };
+};
+
+template <typename T, typename U>
+bool operator==(const NumaAllocator<T>&, const NumaAllocator<U>&) { return true; }
+template <typename T, typename U>
+bool operator!=(const NumaAllocator<T>&, const NumaAllocator<U>&) { return false; }
+
+typedef std::vector<double, NumaAllocator<double>> NumaVector;
@@ -0,0 +1,57 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+// Counter-based Philox4x32-10 generator (Salmon et al., SC'11).
+// Every (counter, stream) pair maps to an independent block of 4 random
+// words, so any element of a matrix can be generated without the others.
+class Philox4x32 {
+public:
+    explicit Philox4x32(uint64_t seed)
+        : m_key0(static_cast<uint32_t>(seed)), m_key1(static_cast<uint32_t>(seed >> 32)) {}
+
+    std::array<uint32_t, 4> operator()(uint64_t counter, uint32_t stream = 0) const {
+        uint32_t c0 = static_cast<uint32_t>(counter);
+        uint32_t c1 = static_cast<uint32_t>(counter >> 32);
+        uint32_t c2 = stream;
+        uint32_t c3 = 0;
+        uint32_t k0 = m_key0, k1 = m_key1;
+
+        for (int round = 0; round < 10; ++round) {
+            const uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c0;
+            const uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c2;
+            const uint32_t hi0 = static_cast<uint32_t>(p0 >> 32), lo0 = static_cast<uint32_t>(p0);
+            const uint32_t hi1 = static_cast<uint32_t>(p1 >> 32), lo1 = static_cast<uint32_t>(p1);
+            c0 = hi1 ^ c1 ^ k0;
+            c1 = lo1;
+            c2 = hi0 ^ c3 ^ k1;
+            c3 = lo0;
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        return {{c0, c1, c2, c3}};
+    }
+
+    // Uniform double in [0, 1) with 53 random bits
+    double uniform(uint64_t counter, uint32_t stream = 0) const {
+        const std::array<uint32_t, 4> w = (*this)(counter, stream);
+        return to_unit(w[0], w[1]);
+    }
+
+    // Standard normal via Box-Muller
+    double normal(uint64_t counter, uint32_t stream = 0) const {
+        const std::array<uint32_t, 4> w = (*this)(counter, stream);
+        const double u1 = 1.0 - to_unit(w[0], w[1]);  // (0, 1], safe for log
+        const double u2 = to_unit(w[2], w[3]);
+        const double two_pi = 6.28318530717958647692;
+        return std::sqrt(-2.0 * std::log(u1)) * std::cos(two_pi * u2);
+    }
+
+private:
+    uint32_t m_key0, m_key1;
+
+    static double to_unit(uint32_t a, uint32_t b) {
+        return ((a >> 5) * 67108864.0 + (b >> 6)) * (1.0 / 9007199254740992.0);
+    }
+};
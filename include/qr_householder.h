@@ -4,7 +4,7 @@
 struct QRResult {
     Matrix Q;
     Matrix R;
-    
+
     // No default constructor needed
     QRResult(Matrix Q_mat, Matrix R_mat) : Q(std::move(Q_mat)), R(std::move(R_mat)) {}
 };
@@ -12,13 +12,45 @@ struct QRResult {
 class HouseholderQR {
 public:
     static QRResult decompose(const Matrix& A);
-    
+
+    // Economy-size factorization: Q is m×t, R is t×n with t = min(m, n)
+    static QRResult decompose_economy(const Matrix& A);
+
+    // Economy-size factorization with column pivoting: A(:, perm) = QR
+    static QRResult decompose_pivoted(const Matrix& A, std::vector<int>& perm);
+
 private:
+    // Build reflector for column k of R; returns false for a zero column
+    static bool make_householder(
+        const Matrix& R,
+        int k,
+        std::vector<double>& v,
+        double& beta,
+        double& sigma
+    );
+
     static void apply_householder(
-        Matrix& R, 
-        Matrix& Q, 
-        const std::vector<double>& v, 
-        double beta, 
+        Matrix& R,
+        Matrix& Q,
+        const std::vector<double>& v,
+        double beta,
         int k
     );
-};
\ No newline at end of file
+
+    // Apply (I - beta*v*v^T) from the left to rows k.. and columns col_begin..
+    static void apply_householder_left(
+        Matrix& M,
+        const std::vector<double>& v,
+        double beta,
+        int k,
+        int col_begin
+    );
+
+    // Form the thin Q (m×t) from the stored reflectors
+    static Matrix accumulate_q(
+        int m,
+        int t,
+        const std::vector<std::vector<double>>& vs,
+        const std::vector<double>& betas
+    );
+};
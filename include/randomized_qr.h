@@ -0,0 +1,66 @@
+#pragma once
+#include "matrix.h"
+#include <vector>
+
+// Random test matrix used to sample the range of A
+enum class SketchType {
+    Gaussian,    // Dense i.i.d. N(0, 1) entries
+    SparseSign,  // Few ±1 entries per row of the sketch
+    SRHT         // Subsampled randomized Hadamard transform
+};
+
+struct RandomizedQROptions {
+    int rank = 0;                // Target rank k (0 = adaptive, driven by tolerance)
+    int oversampling = 10;       // Extra sketch columns p in fixed-rank mode
+    int power_iterations = 1;    // Subspace iterations q, i.e. sample (AAᵀ)^q A
+    double tolerance = 0.0;      // Target error estimate in adaptive mode
+    int block_size = 32;         // Basis columns added per adaptive step
+    int max_rank = 512;          // Adaptive mode limit (0 = min(m, n), no cap)
+    int sparse_nnz = 8;          // Nonzeros per sketch row for SparseSign
+    int error_probes = 10;       // Gaussian probes for the error estimate
+    SketchType sketch = SketchType::Gaussian;
+    unsigned long long seed = 42;
+};
+
+struct LowRankQRResult {
+    Matrix Q;               // m×k, orthonormal columns
+    Matrix R;               // k×n, upper trapezoidal
+    std::vector<int> perm;  // Column permutation: A(:, perm) ≈ QR
+    double error_estimate;  // Probabilistic bound on ||A(:, perm) - QR||₂
+
+    LowRankQRResult(Matrix Q_mat, Matrix R_mat, std::vector<int> p, double err)
+        : Q(std::move(Q_mat)), R(std::move(R_mat)), perm(std::move(p)), error_estimate(err) {}
+};
+
+class RandomizedQR {
+public:
+    // Rank-k QR via randomized range finder (Halko, Martinsson & Tropp)
+    static LowRankQRResult decompose(
+        const Matrix& A,
+        const RandomizedQROptions& opts = RandomizedQROptions()
+    );
+
+    // 10·sqrt(2/π)·max_i ||(A(:, perm) - QR) ω_i||₂, holds with prob. 1 - 10^-probes
+    static double estimate_error(
+        const Matrix& A,
+        const Matrix& Q,
+        const Matrix& R,
+        const std::vector<int>& perm,
+        int probes,
+        unsigned long long seed
+    );
+
+private:
+    // Y = AΩ for an n×l sketch Ω of the requested type
+    static Matrix sketch(const Matrix& A, int l, const RandomizedQROptions& opts,
+                         unsigned long long seed);
+
+    // Orthonormal basis of range((AAᵀ)^q Y), re-orthogonalized each half step
+    static Matrix power_iterate(const Matrix& A, Matrix Y, int q);
+
+    // Fixed-rank range finder with l = k + p samples
+    static Matrix range_fixed(const Matrix& A, int l, const RandomizedQROptions& opts);
+
+    // Blocked adaptive range finder, grows Q (and B = QᵀA) until the estimate meets tolerance
+    static Matrix range_adaptive(const Matrix& A, const RandomizedQROptions& opts, Matrix& B);
+};
@@ -1,6 +1,9 @@
 #include "benchmark.h"
 #include "qr_householder.h"
 #include "error_metrics.h"
+#include "randomized_qr.h"
+#include "kernels.h"
+#include "numa_placement.h"
 #include <iostream>
 #include <iomanip>
 #include <chrono>
@@ -16,7 +19,7 @@ double Benchmark::measure_cpu_time(std::function<void()> func) {
 
 // Test a specific matrix dimension
 void Benchmark::test_dimension(int n) {
-    Matrix A = Matrix::random(n, n);
+    Matrix A = Matrix::random(n, n, -1.0, 1.0, n);
     
     // Initialize matrices with proper dimensions
     Matrix Q = Matrix::identity(n);  // Initialize as identity matrix
@@ -49,6 +52,8 @@ void Benchmark::run() {
     std::vector<int> sizes = {100, 500, 1000};
     
     // Print table header
+    std::cout << "\n";
+    Kernels::report(std::cout);
     std::cout << "\n| Dimension | α-Error (A-QR) | β-Error (QᵀQ-I) | γ-Error (AR⁻¹-Q) | cond(R) | Time (s) |\n";
     std::cout << "|----------|----------------|-----------------|------------------|---------|----------|\n";
     
@@ -59,4 +64,208 @@ void Benchmark::run() {
     
     std::cout << "\nBenchmark complete.\n\n";
     
-}
\ No newline at end of file
+}
+
+// Test randomized low-rank QR on an n×n matrix of numerical rank `rank`
+void Benchmark::test_randomized(int n, int rank, const RandomizedQROptions& opts, const char* mode) {
+    // A = XY + small noise, so the trailing singular values are ~1e-8
+    Matrix X = Matrix::random(n, rank, -1.0, 1.0, 3 * n);
+    Matrix Y = Matrix::random(rank, n, -1.0, 1.0, 3 * n + 1);
+    Matrix A = X * Y;
+    Matrix noise = Matrix::random(n, n, -1e-8, 1e-8, 3 * n + 2);
+    A = A - noise;
+
+    LowRankQRResult result(Matrix(1, 1), Matrix(1, 1), std::vector<int>(), 0.0);
+    double time = measure_cpu_time([&]() {
+        result = RandomizedQR::decompose(A, opts);
+    });
+
+    // Relative ||A(:, perm) - QR||∞ / ||A||∞
+    Matrix AP(n, n);
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            AP(i, j) = A(i, result.perm[j]);
+    double err = (AP - result.Q * result.R).normInf() / A.normInf();
+
+    std::cout << "| " << std::setw(4) << n << " | "
+              << std::setw(12) << mode << " | "
+              << std::setw(4) << result.Q.cols() << " | "
+              << std::scientific << std::setprecision(2) << err << " | "
+              << result.error_estimate << " | "
+              << std::setw(8) << std::fixed << std::setprecision(3) << time << " |\n";
+}
+
+// Randomized low-rank QR benchmark
+void Benchmark::run_randomized() {
+    std::vector<int> sizes = {1000, 2000, 4000};
+    const int rank = 50;
+
+    std::cout << "\n";
+    Kernels::report(std::cout);
+    std::cout << "\n| Dimension | Mode         | Rank | Rel. Error (A-QR) | Error estimate | Time (s) |\n";
+    std::cout << "|----------|--------------|------|-------------------|----------------|----------|\n";
+
+    // Fixed rank with each sketch type, then tolerance-driven growth
+    RandomizedQROptions gaussian;
+    gaussian.rank = rank;
+    RandomizedQROptions sparse = gaussian;
+    sparse.sketch = SketchType::SparseSign;
+    RandomizedQROptions srht = gaussian;
+    srht.sketch = SketchType::SRHT;
+    RandomizedQROptions adaptive;
+    adaptive.tolerance = 1e-3;
+
+    for (int n : sizes) {
+        test_randomized(n, rank, gaussian, "gaussian");
+        test_randomized(n, rank, sparse, "sparse-sign");
+        test_randomized(n, rank, srht, "srht");
+        test_randomized(n, rank, adaptive, "adaptive");
+    }
+
+    std::cout << "\nRandomized benchmark complete.\n\n";
+}
+
+// Solve AX = B through QR: X = R⁻¹QᵀB by back substitution
+static Matrix qr_solve(const Matrix& A, const Matrix& B) {
+    QRResult qr = HouseholderQR::decompose(A);
+    Matrix X = qr.Q.transpose() * B;
+    const int n = A.rows();
+    for (int c = 0; c < X.cols(); ++c) {
+        for (int i = n - 1; i >= 0; --i) {
+            double sum = X(i, c);
+            for (int k = i + 1; k < n; ++k)
+                sum -= qr.R(i, k) * X(k, c);
+            X(i, c) = sum / qr.R(i, i);
+        }
+    }
+    return X;
+}
+
+// Relative residual ||AX - B||∞ / (||A||∞ ||X||∞)
+static double solve_residual(const Matrix& A, const Matrix& X, const Matrix& B) {
+    return (A * X - B).normInf() / (A.normInf() * X.normInf());
+}
+
+// Compare LU and QR solves of Ax = b, plus the LU-based inverse
+void Benchmark::test_solve(int n) {
+    Matrix A = Matrix::random(n, n, -1.0, 1.0, 2 * n);
+    Matrix b = Matrix::random(n, 1, -1.0, 1.0, 2 * n + 1);
+    Matrix x_lu(1, 1), x_qr(1, 1), inv(1, 1);
+
+    double time_lu = measure_cpu_time([&]() { x_lu = A.lu_solve(b); });
+    double time_qr = measure_cpu_time([&]() { x_qr = qr_solve(A, b); });
+    double time_inv = measure_cpu_time([&]() { inv = A.inverse(); });
+
+    double err_lu = solve_residual(A, x_lu, b);
+    double err_qr = solve_residual(A, x_qr, b);
+    double err_inv = (A * inv - Matrix::identity(n)).normInf();
+
+    std::cout << "| " << std::setw(4) << n << " | "
+              << std::setw(8) << std::fixed << std::setprecision(3) << time_lu << " | "
+              << std::scientific << std::setprecision(2) << err_lu << " | "
+              << std::setw(8) << std::fixed << std::setprecision(3) << time_qr << " | "
+              << std::scientific << std::setprecision(2) << err_qr << " | "
+              << std::setw(8) << std::fixed << std::setprecision(3) << time_inv << " | "
+              << std::scientific << std::setprecision(2) << err_inv << " |\n";
+}
+
+// Linear solve benchmark: blocked LU vs Householder QR
+void Benchmark::run_solve() {
+    std::vector<int> sizes = {250, 500, 1000};
+
+    std::cout << "\n";
+    Kernels::report(std::cout);
+    std::cout << "\n| Dimension | LU solve (s) | LU residual | QR solve (s) | QR residual | Inverse (s) | ||AA⁻¹-I||∞ |\n";
+    std::cout << "|----------|--------------|-------------|--------------|-------------|-------------|-------------|\n";
+
+    for (int n : sizes) {
+        test_solve(n);
+    }
+
+    std::cout << "\nSolve benchmark complete.\n\n";
+}
+
+// STREAM-style triad a = b + s*c on Matrix storage placed by the active policy (GB/s)
+double Benchmark::triad_bandwidth() {
+    const int rows = 2048, cols = 4096;  // 64 MB per array
+    Matrix a(rows, cols), b(rows, cols, 1.0), c(rows, cols, 2.0);
+    double* pa = a.data();
+    const double* pb = b.data();
+    const double* pc = c.data();
+
+    double best = 1e30;
+    for (int rep = 0; rep < 5; ++rep) {
+        double time = measure_cpu_time([&]() {
+            #pragma omp parallel for schedule(static, Numa::tile_rows)
+            for (int i = 0; i < rows; ++i) {
+                const size_t base = static_cast<size_t>(i) * cols;
+                for (int j = 0; j < cols; ++j)
+                    pa[base + j] = pb[base + j] + 3.0 * pc[base + j];
+            }
+        });
+        if (time < best) best = time;
+    }
+    return 3.0 * sizeof(double) * rows * cols / best / 1e9;
+}
+
+// NUMA benchmark: bandwidth per memory node, then thread scaling per placement policy
+void Benchmark::run_numa() {
+    const NumaPolicy saved_policy = Numa::policy();
+    const int saved_node = Numa::bind_node();
+    const int max_threads = Numa::max_threads();
+    const int n = 2000;
+
+    std::cout << "\n";
+    Kernels::report(std::cout);
+    Numa::report(std::cout);
+
+    // Per-node bandwidth: all threads, memory bound to one node
+    std::cout << "\n| Memory node | Triad (GB/s) |\n";
+    std::cout << "|-------------|--------------|\n";
+    if (Numa::libnuma_available()) {
+        for (int node : Numa::memory_nodes()) {
+            Numa::set_policy(NumaPolicy::Bind, node);
+            std::cout << "| " << std::setw(11) << node << " | "
+                      << std::setw(12) << std::fixed << std::setprecision(2) << triad_bandwidth() << " |\n";
+        }
+    } else {
+        Numa::set_policy(NumaPolicy::FirstTouch);
+        std::cout << "|         all | " << std::setw(12) << std::fixed << std::setprecision(2)
+                  << triad_bandwidth() << " |  (libnuma unavailable)\n";
+    }
+
+    std::vector<NumaPolicy> policies = {NumaPolicy::Serial, NumaPolicy::FirstTouch};
+    if (Numa::libnuma_available()) policies.push_back(NumaPolicy::Interleave);
+    const char* names[] = {"serial", "firsttouch", "interleave", "bind"};
+
+    std::vector<int> threads;
+    for (int t = 1; t < max_threads; t *= 2) threads.push_back(t);
+    threads.push_back(max_threads);
+
+    // Scaling: same work, pages placed serially (one node) vs by policy
+    std::cout << "\n| Threads | Policy     | Triad (GB/s) | LU n=" << n << " (s) | LU speedup |\n";
+    std::cout << "|---------|------------|--------------|---------------|------------|\n";
+    std::vector<double> base_time(policies.size(), 0.0);
+    for (int t : threads) {
+        Numa::set_threads(t);
+        for (size_t p = 0; p < policies.size(); ++p) {
+            Numa::set_policy(policies[p]);
+            const double bandwidth = triad_bandwidth();
+
+            Matrix A = Matrix::random(n, n, -1.0, 1.0, n);
+            Matrix b = Matrix::random(n, 1, -1.0, 1.0, n + 1);
+            double time = measure_cpu_time([&]() { A.lu_solve(b); });
+            if (t == 1) base_time[p] = time;
+
+            std::cout << "| " << std::setw(7) << t << " | "
+                      << std::setw(10) << names[static_cast<int>(policies[p])] << " | "
+                      << std::setw(12) << std::fixed << std::setprecision(2) << bandwidth << " | "
+                      << std::setw(13) << std::setprecision(3) << time << " | "
+                      << std::setw(10) << std::setprecision(2) << base_time[p] / time << " |\n";
+        }
+    }
+
+    Numa::set_policy(saved_policy, saved_node);
+    Numa::set_threads(max_threads);
+    std::cout << "\nNUMA benchmark complete.\n\n";
+}
@@ -1,4 +1,5 @@
 #include "error_metrics.h"
+#include "kernels.h"
 #include <stdexcept>
 
 // ||A - QR||∞ computation
@@ -32,17 +33,19 @@ Matrix ErrorMetrics::invert_upper_triangular(const Matrix& R) {
     
     const int n = R.rows();
     Matrix inv(n, n, 0.0);
+    const KernelTable& kern = Kernels::get();
+    const double* r = R.data();
+    double* x = inv.data();
     
-    // Backward substitution for each column
-    for (int j = n-1; j >= 0; --j) {
-        inv(j, j) = 1.0 / R(j, j);
-        for (int i = j-1; i >= 0; --i) {
-            double sum = 0.0;
-            for (int k = i+1; k <= j; ++k) {
-                sum += R(i, k) * inv(k, j);
-            }
-            inv(i, j) = -sum / R(i, i);
-        }
+    // Backward substitution by rows: inv(i, i:) = (e_i - R(i, i+1:) inv(i+1:, i:)) / R(i, i)
+    for (int i = n-1; i >= 0; --i) {
+        double* row = x + static_cast<size_t>(i) * n + i;
+        row[0] = 1.0;
+        if (i < n-1)  // Row i+1 would be past the end for the last row
+            kern.row_gemm(n - i - 1, n - i, -1.0, r + static_cast<size_t>(i) * n + i + 1,
+                          x + static_cast<size_t>(i + 1) * n + i, n, row);
+        const double inv_diag = 1.0 / R(i, i);
+        for (int j = 0; j < n - i; ++j) row[j] *= inv_diag;
     }
     return inv;
 }
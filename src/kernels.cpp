@@ -0,0 +1,59 @@
+#include "kernels.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// Variants built from kernels_impl.cpp
+extern const KernelTable kernels_sse2;
+extern const KernelTable kernels_avx2;
+extern const KernelTable kernels_avx512;
+
+// Helper: CPU (and OS, via XCR0) support for a kernel set
+static bool supported(const KernelTable& k) {
+    __builtin_cpu_init();
+    if (&k == &kernels_avx512)
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("fma");
+    if (&k == &kernels_avx2)
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return true;  // SSE2 is part of the x86-64 baseline
+}
+
+const KernelTable* Kernels::select() {
+    const KernelTable* all[] = {&kernels_avx512, &kernels_avx2, &kernels_sse2};
+
+    const KernelTable* best = &kernels_sse2;
+    for (const KernelTable* k : all) {
+        if (supported(*k)) {
+            best = k;
+            break;
+        }
+    }
+
+    const char* env = std::getenv("QR_KERNELS");
+    if (env == nullptr || *env == '\0') return best;
+
+    for (const KernelTable* k : all) {
+        if (std::strcmp(env, k->name) != 0) continue;
+        if (supported(*k)) return k;
+        std::cerr << "Warning: QR_KERNELS=" << env << " is not supported by this CPU, using "
+                  << best->name << "\n";
+        return best;
+    }
+    std::cerr << "Warning: unknown QR_KERNELS=" << env << " (expected sse2, avx2 or avx512), using "
+              << best->name << "\n";
+    return best;
+}
+
+const KernelTable& Kernels::get() {
+    static const KernelTable* active = select();
+    return *active;
+}
+
+void Kernels::report(std::ostream& os) {
+    const KernelTable& active = get();  // May print an override warning first
+    os << "Kernel set: " << active.name << " (supported:";
+    const KernelTable* all[] = {&kernels_sse2, &kernels_avx2, &kernels_avx512};
+    for (const KernelTable* k : all)
+        if (supported(*k)) os << " " << k->name;
+    os << "; override with QR_KERNELS)\n";
+}
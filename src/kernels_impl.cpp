@@ -0,0 +1,80 @@
+// Compiled once per instruction set with -DKERNEL_ISA=<name> and matching
+// -m flags (see Makefile). Do not include standard headers with inline
+// functions here: their out-of-line copies could be linked into baseline code.
+#include "kernels.h"
+
+#ifndef KERNEL_ISA
+#error "KERNEL_ISA must be defined when compiling kernels_impl.cpp"
+#endif
+
+#define KERNEL_STR2(x) #x
+#define KERNEL_STR(x) KERNEL_STR2(x)
+#define KERNEL_CAT2(a, b) a##b
+#define KERNEL_CAT(a, b) KERNEL_CAT2(a, b)
+
+namespace {
+
+double dot(const double* x, const double* y, int n) {
+    double sum = 0.0;
+    #pragma omp simd reduction(+:sum)
+    for (int i = 0; i < n; ++i) sum += x[i] * y[i];
+    return sum;
+}
+
+void axpy(int n, double alpha, const double* x, double* y) {
+    #pragma omp simd
+    for (int i = 0; i < n; ++i) y[i] += alpha * x[i];
+}
+
+double sum_abs(const double* x, int n) {
+    double sum = 0.0;
+    #pragma omp simd reduction(+:sum)
+    for (int i = 0; i < n; ++i) sum += (x[i] < 0.0) ? -x[i] : x[i];
+    return sum;
+}
+
+double max_abs(const double* x, int n) {
+    double max = 0.0;
+    #pragma omp simd reduction(max:max)
+    for (int i = 0; i < n; ++i) {
+        const double abs_val = (x[i] < 0.0) ? -x[i] : x[i];
+        max = (abs_val > max) ? abs_val : max;
+    }
+    return max;
+}
+
+// Four rows of B per pass so each element of c is loaded and stored once per four updates
+void row_gemm(int k, int n, double alpha, const double* a,
+              const double* B, size_t ldb, double* c) {
+    int p = 0;
+    for (; p + 4 <= k; p += 4) {
+        const double a0 = alpha * a[p];
+        const double a1 = alpha * a[p + 1];
+        const double a2 = alpha * a[p + 2];
+        const double a3 = alpha * a[p + 3];
+        const double* b0 = B + static_cast<size_t>(p) * ldb;
+        const double* b1 = b0 + ldb;
+        const double* b2 = b1 + ldb;
+        const double* b3 = b2 + ldb;
+        #pragma omp simd
+        for (int j = 0; j < n; ++j)
+            c[j] += a0 * b0[j] + a1 * b1[j] + a2 * b2[j] + a3 * b3[j];
+    }
+    for (; p < k; ++p) {
+        const double ap = alpha * a[p];
+        const double* bp = B + static_cast<size_t>(p) * ldb;
+        #pragma omp simd
+        for (int j = 0; j < n; ++j) c[j] += ap * bp[j];
+    }
+}
+
+}  // namespace
+
+extern const KernelTable KERNEL_CAT(kernels_, KERNEL_ISA) = {
+    KERNEL_STR(KERNEL_ISA),
+    dot,
+    axpy,
+    sum_abs,
+    max_abs,
+    row_gemm
+};
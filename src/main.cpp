@@ -2,17 +2,42 @@
 #include "qr_householder.h"
 #include "error_metrics.h"
 #include "benchmark.h"
+#include "kernels.h"
+#include "numa_placement.h"
 #include <iostream>
 #include <string>
 #include <fstream>    // For file existence check
 #include <limits>     // For input validation
 
 int main(int argc, char* argv[]) {
+    // Pin OpenMP threads so first-touched pages stay local to their rows
+    Numa::pin_threads();
+    
     // Command-line benchmark handling
     if (argc > 1 && std::string(argv[1]) == "bench") {
         Benchmark::run();
         return 0;
     }
+    if (argc > 1 && std::string(argv[1]) == "bench-rqr") {
+        Benchmark::run_randomized();
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "kernels") {
+        Kernels::report(std::cout);
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "numa") {
+        Numa::report(std::cout);
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "bench-numa") {
+        Benchmark::run_numa();
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "bench-solve") {
+        Benchmark::run_solve();
+        return 0;
+    }
     
     std::cout << "QR Householder Factorization\n"
               << "============================\n\n";
@@ -98,7 +123,11 @@ int main(int argc, char* argv[]) {
                 }
                 test.close();
                 
-                A = Matrix::loadFromFile(path);
+                // Binary files come from generate_matrices --format binary
+                const std::string ext = ".bin";
+                const bool binary = path.size() >= ext.size() &&
+                    path.compare(path.size() - ext.size(), ext.size(), ext) == 0;
+                A = binary ? Matrix::loadFromBinaryFile(path) : Matrix::loadFromFile(path);
                 std::cout << "Loaded matrix (" << A.rows() << "x" << A.cols() << ")\n";
                 
                 // Dimension limit check
@@ -1,20 +1,40 @@
 #include "matrix.h"
+#include "matrix_generator.h"
+#include "kernels.h"
 #include <iostream>
 #include <sstream>
 #include <fstream>
 #include <cmath>
 #include <algorithm>
 #include <iomanip>
-#include <random>
+#include <cstdint>
 #include <stdexcept>
 #include <functional>  
 
 // Constructors
 Matrix::Matrix(int rows, int cols, double init_val) 
-    : m_rows(rows), m_cols(cols), m_data(rows * cols, init_val) 
+    : m_rows(rows), m_cols(cols)
 {
     if (rows <= 0 || cols <= 0) 
         throw std::invalid_argument("Matrix dimensions must be positive");
+    
+    // Allocate without touching, then fill so pages land where the rows are used
+    m_data.resize(static_cast<size_t>(rows) * cols);
+    Numa::fill(m_data.data(), rows, cols, init_val);
+}
+
+Matrix::Matrix(const Matrix& other)
+    : m_rows(other.m_rows), m_cols(other.m_cols), m_data(other.m_data.size())
+{
+    Numa::copy(m_data.data(), other.m_data.data(), m_rows, m_cols);
+}
+
+Matrix& Matrix::operator=(const Matrix& other) {
+    if (this != &other) {
+        Matrix tmp(other);
+        *this = std::move(tmp);
+    }
+    return *this;
 }
 
 Matrix::Matrix(const std::vector<std::vector<double>>& data) {
@@ -23,12 +43,12 @@ Matrix::Matrix(const std::vector<std::vector<double>>& data) {
     
     m_rows = data.size();
     m_cols = data[0].size();
-    m_data.resize(m_rows * m_cols);
+    m_data.resize(static_cast<size_t>(m_rows) * m_cols);
     
     for (int i = 0; i < m_rows; ++i) {
         if (static_cast<int>(data[i].size()) != m_cols)
             throw std::invalid_argument("Inconsistent row size");
-        std::copy(data[i].begin(), data[i].end(), m_data.begin() + i * m_cols);
+        std::copy(data[i].begin(), data[i].end(), m_data.begin() + static_cast<size_t>(i) * m_cols);
     }
 }
 
@@ -36,13 +56,13 @@ Matrix::Matrix(const std::vector<std::vector<double>>& data) {
 double& Matrix::operator()(int i, int j) {
     if (i < 0 || i >= m_rows || j < 0 || j >= m_cols)
         throw std::out_of_range("Matrix index out of bounds");
-    return m_data[i * m_cols + j];
+    return m_data[static_cast<size_t>(i) * m_cols + j];
 }
 
 const double& Matrix::operator()(int i, int j) const {
     if (i < 0 || i >= m_rows || j < 0 || j >= m_cols)
         throw std::out_of_range("Matrix index out of bounds");
-    return m_data[i * m_cols + j];
+    return m_data[static_cast<size_t>(i) * m_cols + j];
 }
 
 // Matrix subtraction
@@ -51,7 +71,7 @@ Matrix Matrix::operator-(const Matrix& other) const {
         throw std::invalid_argument("Matrix dimensions mismatch");
     
     Matrix result(m_rows, m_cols);
-    for (int i = 0; i < m_rows * m_cols; ++i)
+    for (size_t i = 0; i < m_data.size(); ++i)
         result.m_data[i] = m_data[i] - other.m_data[i];
     return result;
 }
@@ -62,14 +82,12 @@ Matrix Matrix::operator*(const Matrix& other) const {
         throw std::invalid_argument("Matrix dimensions mismatch");
     
     Matrix result(m_rows, other.m_cols, 0.0);
+    const KernelTable& kern = Kernels::get();
+    const int n = other.m_cols;
+    #pragma omp parallel for schedule(static, Numa::tile_rows)
     for (int i = 0; i < m_rows; ++i) {
-        for (int k = 0; k < m_cols; ++k) {
-            const double tmp = m_data[i * m_cols + k];
-            for (int j = 0; j < other.m_cols; ++j) {
-                result.m_data[i * other.m_cols + j] += 
-                    tmp * other.m_data[k * other.m_cols + j];
-            }
-        }
+        kern.row_gemm(m_cols, n, 1.0, m_data.data() + static_cast<size_t>(i) * m_cols,
+                      other.m_data.data(), n, result.m_data.data() + static_cast<size_t>(i) * n);
     }
     return result;
 }
@@ -85,11 +103,10 @@ Matrix Matrix::transpose() const {
 
 // Infinity norm (max row sum)
 double Matrix::normInf() const noexcept {
+    const KernelTable& kern = Kernels::get();
     double max_sum = 0.0;
     for (int i = 0; i < m_rows; ++i) {
-        double row_sum = 0.0;
-        for (int j = 0; j < m_cols; ++j)
-            row_sum += std::fabs((*this)(i, j));
+        const double row_sum = kern.sum_abs(m_data.data() + static_cast<size_t>(i) * m_cols, m_cols);
         if (row_sum > max_sum) max_sum = row_sum;
     }
     return max_sum;
@@ -103,16 +120,9 @@ Matrix Matrix::identity(int n) {
     return I;
 }
 
-// Random matrix generator
-Matrix Matrix::random(int rows, int cols, double min, double max) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<double> dist(min, max);
-    
-    Matrix mat(rows, cols);
-    for (int i = 0; i < rows * cols; ++i)
-        mat.m_data[i] = dist(gen);
-    return mat;
+// Random matrix generator (counter-based, filled in parallel)
+Matrix Matrix::random(int rows, int cols, double min, double max, unsigned long long seed) {
+    return MatrixGenerator::uniform(rows, cols, min, max, seed);
 }
 
 // File I/O - Load matrix from text file
@@ -136,12 +146,34 @@ Matrix Matrix::loadFromFile(const std::string& path) {
     return Matrix(data);
 }
 
-// LU Decomposition helper for inverse
+// File I/O - Load matrix written by MatrixGenerator::write_binary
+Matrix Matrix::loadFromBinaryFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("Cannot open file: " + path);
+    
+    int32_t dims[2];
+    if (!file.read(reinterpret_cast<char*>(dims), sizeof(dims)))
+        throw std::runtime_error("Invalid binary matrix header: " + path);
+    
+    Matrix mat(dims[0], dims[1]);
+    file.read(reinterpret_cast<char*>(mat.m_data.data()),
+              static_cast<std::streamsize>(sizeof(double) * mat.m_data.size()));
+    if (!file) throw std::runtime_error("Truncated binary matrix file: " + path);
+    return mat;
+}
+
+// LU Decomposition: right-looking blocked algorithm with scaled partial pivoting.
+// On exit the strict lower part holds L (unit diagonal), the upper part holds U,
+// and row j was swapped with row perm[j] at step j.
 void Matrix::lu_decompose(std::vector<int>& perm, int& sign) {
     if (m_rows != m_cols)
         throw std::logic_error("LU decomposition requires square matrix");
     
     const int n = m_rows;
+    const int nb = Numa::tile_rows;  // Panel width, one row tile
+    const int chunk = 256;   // Column chunk for the trailing update
+    double* a = m_data.data();
+    const KernelTable& kern = Kernels::get();
     perm.resize(n);
     std::vector<double> row_scales(n);
     sign = 1;
@@ -150,105 +182,150 @@ void Matrix::lu_decompose(std::vector<int>& perm, int& sign) {
     for (int i = 0; i < n; ++i) {
         perm[i] = i;
         double max_val = 0.0;
+        const double* row = a + static_cast<size_t>(i) * n;
         for (int j = 0; j < n; ++j) {
-            const double abs_val = std::fabs((*this)(i, j));
+            const double abs_val = std::fabs(row[j]);
             if (abs_val > max_val) max_val = abs_val;
         }
         if (max_val == 0.0) throw std::runtime_error("Matrix is singular");
         row_scales[i] = 1.0 / max_val;
     }
 
-    // Crout's algorithm
-    for (int j = 0; j < n; ++j) {
-        // Compute elements of U
-        for (int i = 0; i < j; ++i) {
-            double sum = (*this)(i, j);
-            for (int k = 0; k < i; ++k)
-                sum -= (*this)(i, k) * (*this)(k, j);
-            (*this)(i, j) = sum;
-        }
-        
-        // Find pivot
-        int pivot_row = j;
-        double max_val = 0.0;
-        for (int i = j; i < n; ++i) {
-            double sum = (*this)(i, j);
-            for (int k = 0; k < j; ++k)
-                sum -= (*this)(i, k) * (*this)(k, j);
-            (*this)(i, j) = sum;
-            
-            const double scaled_val = row_scales[i] * std::fabs(sum);
-            if (scaled_val >= max_val) {
-                max_val = scaled_val;
-                pivot_row = i;
+    for (int k0 = 0; k0 < n; k0 += nb) {
+        const int k1 = std::min(n, k0 + nb);
+
+        // Factor panel A(k0:n, k0:k1) with unblocked rank-1 updates
+        for (int j = k0; j < k1; ++j) {
+            // Find pivot
+            int pivot_row = j;
+            double max_val = 0.0;
+            for (int i = j; i < n; ++i) {
+                const double scaled_val = row_scales[i] * std::fabs(a[static_cast<size_t>(i) * n + j]);
+                if (scaled_val > max_val) {
+                    max_val = scaled_val;
+                    pivot_row = i;
+                }
             }
-        }
-        
-        // Swap rows if needed
-        if (j != pivot_row) {
-            for (int k = 0; k < n; ++k) {
-                using std::swap;
-                swap((*this)(pivot_row, k), (*this)(j, k));
+
+            // Swap whole rows so L and the trailing matrix stay consistent
+            if (j != pivot_row) {
+                std::swap_ranges(a + static_cast<size_t>(j) * n,
+                                 a + static_cast<size_t>(j + 1) * n,
+                                 a + static_cast<size_t>(pivot_row) * n);
+                std::swap(row_scales[j], row_scales[pivot_row]);
+                sign = -sign;
             }
-            sign = -sign;
-            row_scales[pivot_row] = row_scales[j];
+            perm[j] = pivot_row;
+
+            // Check singularity
+            const double* pivot = a + static_cast<size_t>(j) * n;
+            if (std::fabs(pivot[j]) < 1e-12)
+                throw std::runtime_error("Matrix is singular");
+
+            // Compute column of L and update the rest of the panel
+            const double denom = 1.0 / pivot[j];
+            auto panel_update = [&](int r0, int r1) {
+                for (int i = r0; i < r1; ++i) {
+                    double* row = a + static_cast<size_t>(i) * n;
+                    row[j] *= denom;
+                    kern.axpy(k1 - j - 1, -row[j], pivot + j + 1, row + j + 1);
+                }
+            };
+            if (n - j > 256) Numa::for_each_tile(j + 1, n, panel_update);
+            else panel_update(j + 1, n);
         }
-        perm[j] = pivot_row;
-        
-        // Check singularity
-        if (std::fabs((*this)(j, j)) < 1e-12)
-            throw std::runtime_error("Matrix is singular");
-            
-        // Compute elements of L
-        if (j != n-1) {
-            const double denom = 1.0 / (*this)(j, j);
-            for (int i = j+1; i < n; ++i)
-                (*this)(i, j) *= denom;
+
+        if (k1 == n) break;
+
+        // U12 = L11⁻¹ A(k0:k1, k1:n), parallel over column chunks
+        const int width = n - k1;
+        const int num_chunks = (width + chunk - 1) / chunk;
+        #pragma omp parallel for schedule(static)
+        for (int cb = 0; cb < num_chunks; ++cb) {
+            const int c0 = k1 + cb * chunk;
+            const int c1 = std::min(n, c0 + chunk);
+            for (int i = k0 + 1; i < k1; ++i) {
+                double* row = a + static_cast<size_t>(i) * n;
+                kern.row_gemm(i - k0, c1 - c0, -1.0, row + k0,
+                              a + static_cast<size_t>(k0) * n + c0, n, row + c0);
+            }
         }
+
+        // GEMM trailing update: A22 -= L21 * U12 over (row tile, column chunk)
+        // tasks; owner threads start with their own tiles, idle threads help
+        Numa::for_each_tile_chunk(k1, n, num_chunks, [&](int r0, int r1, int cb) {
+            const int c0 = k1 + cb * chunk;
+            const int c1 = std::min(n, c0 + chunk);
+            for (int i = r0; i < r1; ++i) {
+                double* row = a + static_cast<size_t>(i) * n;
+                kern.row_gemm(k1 - k0, c1 - c0, -1.0, row + k0,
+                              a + static_cast<size_t>(k0) * n + c0, n, row + c0);
+            }
+        });
     }
 }
 
-// Matrix inverse using LU decomposition
-Matrix Matrix::inverse() const {
+// Solve AX = B for all columns of B using the LU factors
+Matrix Matrix::lu_solve(const Matrix& B) const {
     if (m_rows != m_cols)
-        throw std::logic_error("Inverse requires square matrix");
+        throw std::logic_error("LU solve requires square matrix");
+    if (B.m_rows != m_rows)
+        throw std::invalid_argument("Matrix dimensions mismatch");
     
     const int n = m_rows;
+    const int r = B.m_cols;
+    const int chunk = 64;  // Right-hand sides per task
     Matrix LU = *this;  // Copy for LU decomposition
     std::vector<int> perm;
     int sign;
     LU.lu_decompose(perm, sign);
-    
-    Matrix inv(n, n, 0.0);
-    
-    // Solve LUx = e_k for each column k
-    for (int k = 0; k < n; ++k) {
-        // Forward substitution (Ly = e_k)
-        std::vector<double> col(n, 0.0);
-        col[k] = 1.0;
-        
-        for (int i = 0; i < n; ++i) {
-            const int pi = perm[i];
-            double sum = col[pi];
-            col[pi] = col[i];
-            for (int j = 0; j < i; ++j)
-                sum -= LU(i, j) * col[j];
-            col[i] = sum;
+
+    Matrix X = B;
+    const KernelTable& kern = Kernels::get();
+    const double* lu = LU.m_data.data();
+    double* x = X.m_data.data();
+
+    // Apply the row interchanges to B
+    for (int j = 0; j < n; ++j) {
+        if (perm[j] != j)
+            std::swap_ranges(x + static_cast<size_t>(j) * r,
+                             x + static_cast<size_t>(j + 1) * r,
+                             x + static_cast<size_t>(perm[j]) * r);
+    }
+
+    // Right-hand sides are independent, so split them across threads
+    const int num_chunks = (r + chunk - 1) / chunk;
+    #pragma omp parallel for schedule(static)
+    for (int cb = 0; cb < num_chunks; ++cb) {
+        const int c0 = cb * chunk;
+        const int c1 = std::min(r, c0 + chunk);
+
+        // Forward substitution (LY = PB), L has unit diagonal
+        for (int i = 1; i < n; ++i) {
+            kern.row_gemm(i, c1 - c0, -1.0, lu + static_cast<size_t>(i) * n,
+                          x + c0, r, x + static_cast<size_t>(i) * r + c0);
         }
-        
-        // Backward substitution (Ux = y)
-        for (int i = n-1; i >= 0; --i) {
-            double sum = col[i];
-            for (int j = i+1; j < n; ++j)
-                sum -= LU(i, j) * col[j];
-            col[i] = sum / LU(i, i);
+
+        // Backward substitution (UX = Y)
+        for (int i = n - 1; i >= 0; --i) {
+            const double* u_row = lu + static_cast<size_t>(i) * n;
+            double* xi = x + static_cast<size_t>(i) * r;
+            if (i < n - 1)  // Row i+1 would be past the end for the last row
+                kern.row_gemm(n - i - 1, c1 - c0, -1.0, u_row + i + 1,
+                              x + static_cast<size_t>(i + 1) * r + c0, r, xi + c0);
+            const double inv_diag = 1.0 / u_row[i];
+            for (int c = c0; c < c1; ++c) xi[c] *= inv_diag;
         }
-        
-        // Set column in inverse matrix
-        for (int i = 0; i < n; ++i)
-            inv(i, k) = col[i];
     }
-    return inv;
+    return X;
+}
+
+// Matrix inverse using LU decomposition
+Matrix Matrix::inverse() const {
+    if (m_rows != m_cols)
+        throw std::logic_error("Inverse requires square matrix");
+    
+    return lu_solve(identity(m_rows));
 }
 
 // Matrix printing
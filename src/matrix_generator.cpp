@@ -0,0 +1,270 @@
+#include "matrix_generator.h"
+#include "philox.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+// Uniform matrix; each entry depends only on (seed, i*cols + j)
+Matrix MatrixGenerator::uniform(int rows, int cols, double min, double max, uint64_t seed) {
+    const Philox4x32 rng(seed);
+    Matrix A(rows, cols);
+    double* a = A.data();
+    const double range = max - min;
+
+    #pragma omp parallel for schedule(static, Numa::tile_rows)
+    for (int i = 0; i < rows; ++i) {
+        const uint64_t base = static_cast<uint64_t>(i) * cols;
+        for (int j = 0; j < cols; ++j)
+            a[base + j] = min + range * rng.uniform(base + j);
+    }
+    return A;
+}
+
+// Gaussian matrix; each entry depends only on (seed, i*cols + j)
+Matrix MatrixGenerator::gaussian(int rows, int cols, uint64_t seed) {
+    const Philox4x32 rng(seed);
+    Matrix A(rows, cols);
+    double* a = A.data();
+
+    #pragma omp parallel for schedule(static, Numa::tile_rows)
+    for (int i = 0; i < rows; ++i) {
+        const uint64_t base = static_cast<uint64_t>(i) * cols;
+        for (int j = 0; j < cols; ++j)
+            a[base + j] = rng.normal(base + j);
+    }
+    return A;
+}
+
+// Stewart's method: Q = D H_0 H_1 ... H_{n-2}, where H_k is a Householder
+// reflector on coordinates k.. built from a Gaussian vector and D fixes signs.
+// Reflector k is regenerated from counters k*n + i, so no storage is needed.
+void MatrixGenerator::apply_orthogonal(Matrix& A, uint64_t seed, uint32_t stream, bool left,
+                                       int reflectors) {
+    const Philox4x32 rng(seed);
+    const int rows = A.rows();
+    const int cols = A.cols();
+    const int n = left ? rows : cols;
+    const int r = (reflectors > 0) ? std::min(reflectors, n - 1) : n - 1;
+    double* a = A.data();
+
+    std::vector<double> signs(n, 1.0);
+    std::vector<double> v(n);
+
+    // A Qᵀ = A H_{r-1} ... H_0 D and QA = D H_0 ... H_{r-1} A: both start at H_{r-1}
+    for (int k = r - 1; k >= 0; --k) {
+        const int len = n - k;
+        const uint64_t base = static_cast<uint64_t>(k) * n;
+        double norm = 0.0;
+        for (int i = 0; i < len; ++i) {
+            v[i] = rng.normal(base + i, stream);
+            norm += v[i] * v[i];
+        }
+        norm = std::sqrt(norm);
+        const double sign = (v[0] >= 0) ? 1.0 : -1.0;
+        signs[k] = -sign;
+        v[0] += sign * norm;
+
+        double vtv = 0.0;
+        for (int i = 0; i < len; ++i) vtv += v[i] * v[i];
+        if (vtv == 0.0) continue;
+        const double beta = 2.0 / vtv;
+
+        if (left) {
+            // A(k:, :) -= beta * v * (vᵀ A(k:, :)), parallel over column chunks
+            const int chunk = 256;
+            const int num_chunks = (cols + chunk - 1) / chunk;
+            #pragma omp parallel for schedule(static)
+            for (int cb = 0; cb < num_chunks; ++cb) {
+                const int c0 = cb * chunk;
+                const int c1 = std::min(cols, c0 + chunk);
+                double w[256] = {0.0};
+                for (int i = 0; i < len; ++i) {
+                    const double* row = a + static_cast<size_t>(k + i) * cols;
+                    for (int c = c0; c < c1; ++c) w[c - c0] += v[i] * row[c];
+                }
+                for (int i = 0; i < len; ++i) {
+                    double* row = a + static_cast<size_t>(k + i) * cols;
+                    const double s = beta * v[i];
+                    for (int c = c0; c < c1; ++c) row[c] -= s * w[c - c0];
+                }
+            }
+        } else {
+            // A(:, k:) -= beta * (A(:, k:) v) vᵀ, parallel over rows
+            #pragma omp parallel for schedule(static, Numa::tile_rows)
+            for (int i = 0; i < rows; ++i) {
+                double* row = a + static_cast<size_t>(i) * cols + k;
+                double dot = 0.0;
+                for (int j = 0; j < len; ++j) dot += row[j] * v[j];
+                const double s = beta * dot;
+                for (int j = 0; j < len; ++j) row[j] -= s * v[j];
+            }
+        }
+    }
+
+    // Final 1×1 block only exists in the full (Haar) product
+    if (reflectors <= 0)
+        signs[n - 1] = (rng.normal(static_cast<uint64_t>(n - 1) * n, stream) >= 0) ? 1.0 : -1.0;
+
+    if (left) {
+        for (int i = 0; i < rows; ++i) {
+            if (signs[i] > 0) continue;
+            double* row = a + static_cast<size_t>(i) * cols;
+            for (int j = 0; j < cols; ++j) row[j] = -row[j];
+        }
+    } else {
+        #pragma omp parallel for schedule(static, Numa::tile_rows)
+        for (int i = 0; i < rows; ++i) {
+            double* row = a + static_cast<size_t>(i) * cols;
+            for (int j = 0; j < cols; ++j) row[j] *= signs[j];
+        }
+    }
+}
+
+Matrix MatrixGenerator::orthogonal(int n, uint64_t seed, int reflectors) {
+    Matrix Q = Matrix::identity(n);
+    apply_orthogonal(Q, seed, 1, true, reflectors);
+    return Q;
+}
+
+Matrix MatrixGenerator::with_singular_values(const std::vector<double>& sigma, uint64_t seed,
+                                             int reflectors) {
+    const int n = sigma.size();
+    Matrix A(n, n, 0.0);
+    for (int i = 0; i < n; ++i) A(i, i) = sigma[i];
+    apply_orthogonal(A, seed, 1, true, reflectors);   // U Σ
+    apply_orthogonal(A, seed, 2, false, reflectors);  // (U Σ) Vᵀ
+    return A;
+}
+
+Matrix MatrixGenerator::with_condition(int n, double cond, uint64_t seed, int reflectors) {
+    if (cond < 1.0)
+        throw std::invalid_argument("Condition number must be >= 1");
+
+    std::vector<double> sigma(n, 1.0);
+    for (int i = 1; i < n; ++i)
+        sigma[i] = std::pow(cond, -static_cast<double>(i) / (n - 1));
+    return with_singular_values(sigma, seed, reflectors);
+}
+
+Matrix MatrixGenerator::with_eigenvalues(const std::vector<double>& lambda, uint64_t seed,
+                                         int reflectors) {
+    const int n = lambda.size();
+    Matrix A(n, n, 0.0);
+    for (int i = 0; i < n; ++i) A(i, i) = lambda[i];
+    apply_orthogonal(A, seed, 1, true, reflectors);   // Q Λ
+    apply_orthogonal(A, seed, 1, false, reflectors);  // (Q Λ) Qᵀ
+
+    // Remove rounding asymmetry
+    for (int i = 0; i < n; ++i) {
+        for (int j = i + 1; j < n; ++j) {
+            const double avg = 0.5 * (A(i, j) + A(j, i));
+            A(i, j) = A(j, i) = avg;
+        }
+    }
+    return A;
+}
+
+Matrix MatrixGenerator::symmetric(int n, double min, double max, uint64_t seed) {
+    const Philox4x32 rng(seed);
+    Matrix A(n, n);
+    double* a = A.data();
+    const double range = max - min;
+
+    // Entry (i, j) and (j, i) both come from counter min(i,j)*n + max(i,j)
+    #pragma omp parallel for schedule(static, Numa::tile_rows)
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            const uint64_t counter = (i <= j) ? static_cast<uint64_t>(i) * n + j
+                                              : static_cast<uint64_t>(j) * n + i;
+            a[static_cast<size_t>(i) * n + j] = min + range * rng.uniform(counter);
+        }
+    }
+    return A;
+}
+
+Matrix MatrixGenerator::banded(int n, int lower, int upper, uint64_t seed) {
+    if (lower < 0 || upper < 0)
+        throw std::invalid_argument("Bandwidths must be non-negative");
+
+    const Philox4x32 rng(seed);
+    Matrix A(n, n, 0.0);
+    double* a = A.data();
+
+    #pragma omp parallel for schedule(static, Numa::tile_rows)
+    for (int i = 0; i < n; ++i) {
+        const int j0 = std::max(0, i - lower);
+        const int j1 = std::min(n - 1, i + upper);
+        const uint64_t base = static_cast<uint64_t>(i) * n;
+        for (int j = j0; j <= j1; ++j)
+            a[base + j] = -1.0 + 2.0 * rng.uniform(base + j);
+    }
+    return A;
+}
+
+Matrix MatrixGenerator::rank_deficient(int m, int n, int rank, uint64_t seed) {
+    if (rank < 0 || rank > std::min(m, n))
+        throw std::invalid_argument("Rank must lie in [0, min(m, n)]");
+
+    Matrix A(m, n, 0.0);
+    for (int i = 0; i < rank; ++i) A(i, i) = 1.0;
+    apply_orthogonal(A, seed, 1, true, 0);   // U Σ
+    apply_orthogonal(A, seed, 2, false, 0);  // (U Σ) Vᵀ
+    return A;
+}
+
+// Rows are formatted in parallel blocks, then written in order
+void MatrixGenerator::write_text(const Matrix& A, const std::string& path, int precision,
+                                 bool fixed) {
+    std::ofstream file(path);
+    if (!file) throw std::runtime_error("Cannot create file: " + path);
+
+    const int rows = A.rows();
+    const int cols = A.cols();
+    const int block = 64;
+    const double* a = A.data();
+    const char* format = fixed ? "%.*f" : "%.*g";
+    std::vector<std::string> buffers(block);
+
+    for (int r0 = 0; r0 < rows; r0 += block) {
+        const int r1 = std::min(rows, r0 + block);
+
+        #pragma omp parallel for schedule(dynamic)
+        for (int i = r0; i < r1; ++i) {
+            std::string& out = buffers[i - r0];
+            out.clear();
+            char num[64];
+            const double* row = a + static_cast<size_t>(i) * cols;
+            for (int j = 0; j < cols; ++j) {
+                const int len = std::snprintf(num, sizeof(num), format, precision, row[j]);
+                if (len >= static_cast<int>(sizeof(num))) {
+                    // Truncated (very high precision): format again straight into out
+                    const size_t pos = out.size();
+                    out.resize(pos + len + 1);
+                    std::snprintf(&out[pos], len + 1, format, precision, row[j]);
+                    out.resize(pos + len);
+                } else if (len > 0) {
+                    out.append(num, len);
+                }
+                out.push_back(j < cols - 1 ? ' ' : '\n');
+            }
+        }
+
+        for (int i = r0; i < r1; ++i)
+            file.write(buffers[i - r0].data(), buffers[i - r0].size());
+    }
+    if (!file) throw std::runtime_error("Write failed: " + path);
+}
+
+// Layout: int32 rows, int32 cols, then rows*cols doubles in row-major order
+void MatrixGenerator::write_binary(const Matrix& A, const std::string& path) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("Cannot create file: " + path);
+
+    const int32_t dims[2] = {A.rows(), A.cols()};
+    file.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+    file.write(reinterpret_cast<const char*>(A.data()),
+               static_cast<std::streamsize>(sizeof(double) * A.rows() * A.cols()));
+    if (!file) throw std::runtime_error("Write failed: " + path);
+}
@@ -0,0 +1,277 @@
+#include "numa_placement.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef HAVE_LIBNUMA
+#include <numa.h>
+#endif
+
+// Helper: policy state, initialized from QR_NUMA on first use
+struct PolicyState {
+    NumaPolicy policy;
+    int node;
+};
+
+// Helper: node is a memory node this process may allocate on
+static bool valid_node(int node) {
+    const std::vector<int> nodes = Numa::memory_nodes();
+    return std::find(nodes.begin(), nodes.end(), node) != nodes.end();
+}
+
+static PolicyState& state() {
+    static PolicyState s = []() {
+        PolicyState init = {NumaPolicy::FirstTouch, Numa::memory_nodes().front()};
+        const char* env = std::getenv("QR_NUMA");
+        if (env == nullptr || *env == '\0') return init;
+
+        const std::string val = env;
+        const bool needs_libnuma = val == "interleave" || val == "bind" || val.compare(0, 5, "bind:") == 0;
+        if (needs_libnuma && !Numa::libnuma_available()) {
+            // Placement would silently be first-touch, so say so and use it
+            std::cerr << "Warning: QR_NUMA=" << val << " needs libnuma, which is unavailable "
+                      << "in this build or on this system, using firsttouch\n";
+            return init;
+        }
+
+        if (val == "serial") init.policy = NumaPolicy::Serial;
+        else if (val == "firsttouch") init.policy = NumaPolicy::FirstTouch;
+        else if (val == "interleave") init.policy = NumaPolicy::Interleave;
+        else if (val == "bind") init.policy = NumaPolicy::Bind;
+        else if (val.compare(0, 5, "bind:") == 0) {
+            init.policy = NumaPolicy::Bind;
+            char* end = nullptr;
+            const long node = std::strtol(val.c_str() + 5, &end, 10);
+            if (end != val.c_str() + 5 && *end == '\0' && node >= 0 && node <= INT_MAX &&
+                valid_node(static_cast<int>(node))) {
+                init.node = static_cast<int>(node);
+            } else {
+                std::cerr << "Warning: QR_NUMA=" << val << " does not name an allowed memory node, "
+                          << "binding to node " << init.node << "\n";
+            }
+        } else {
+            std::cerr << "Warning: unknown QR_NUMA=" << val
+                      << " (expected serial, firsttouch, interleave or bind[:node])\n";
+        }
+        return init;
+    }();
+    return s;
+}
+
+NumaPolicy Numa::policy() { return state().policy; }
+int Numa::bind_node() { return state().node; }
+
+void Numa::set_policy(NumaPolicy policy, int node) {
+    if ((policy == NumaPolicy::Interleave || policy == NumaPolicy::Bind) && !libnuma_available())
+        throw std::invalid_argument("Interleave and bind policies need libnuma");
+    if (policy == NumaPolicy::Bind && !valid_node(node))
+        throw std::invalid_argument("Node " + std::to_string(node) + " is not an allowed memory node");
+    state().policy = policy;
+    state().node = node;
+}
+
+bool Numa::libnuma_available() {
+#ifdef HAVE_LIBNUMA
+    static const bool available = numa_available() >= 0;
+    return available;
+#else
+    return false;
+#endif
+}
+
+// Node IDs may be sparse and some nodes have no memory, so scan up to
+// numa_max_node() and keep the ones in the allowed memory set
+std::vector<int> Numa::memory_nodes() {
+    std::vector<int> nodes;
+#ifdef HAVE_LIBNUMA
+    if (libnuma_available()) {
+        struct bitmask* allowed = numa_get_mems_allowed();
+        for (int node = 0; node <= numa_max_node(); ++node) {
+            if (numa_bitmask_isbitset(allowed, node) && numa_node_size64(node, nullptr) > 0)
+                nodes.push_back(node);
+        }
+        numa_bitmask_free(allowed);
+    }
+#endif
+    if (nodes.empty()) nodes.push_back(0);
+    return nodes;
+}
+
+int Numa::node_count() { return static_cast<int>(memory_nodes().size()); }
+
+void Numa::fill(double* data, int rows, int cols, double value) {
+    if (policy() == NumaPolicy::Serial) {
+        std::fill(data, data + static_cast<size_t>(rows) * cols, value);
+        return;
+    }
+
+    #pragma omp parallel for schedule(static, tile_rows)
+    for (int i = 0; i < rows; ++i) {
+        double* row = data + static_cast<size_t>(i) * cols;
+        std::fill(row, row + cols, value);
+    }
+}
+
+void Numa::copy(double* dst, const double* src, int rows, int cols) {
+    if (policy() == NumaPolicy::Serial) {
+        std::copy(src, src + static_cast<size_t>(rows) * cols, dst);
+        return;
+    }
+
+    #pragma omp parallel for schedule(static, tile_rows)
+    for (int i = 0; i < rows; ++i) {
+        const size_t offset = static_cast<size_t>(i) * cols;
+        std::copy(src + offset, src + offset + cols, dst + offset);
+    }
+}
+
+// The mapping covers exactly this block, so mbind never touches pages shared
+// with other allocations, and munmap drops the policy with the pages
+void* Numa::allocate_pages(size_t bytes) {
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) throw std::bad_alloc();
+
+#ifdef HAVE_LIBNUMA
+    if (libnuma_available()) {
+        if (policy() == NumaPolicy::Interleave) {
+            numa_interleave_memory(p, bytes, numa_all_nodes_ptr);
+        } else if (policy() == NumaPolicy::Bind) {
+            numa_tonode_memory(p, bytes, bind_node());
+        }
+    }
+#endif
+    return p;
+}
+
+void Numa::free_pages(void* p, size_t bytes) noexcept {
+    if (p != nullptr) munmap(p, bytes);
+}
+
+int Numa::thread_id() {
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+int Numa::thread_count() {
+#ifdef _OPENMP
+    return omp_get_num_threads();
+#else
+    return 1;
+#endif
+}
+
+int Numa::max_threads() {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+void Numa::set_threads(int threads) {
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+#else
+    (void)threads;
+#endif
+    pin_threads();
+}
+
+// Helper: integer from a sysfs topology file, or fallback when it is missing
+static int read_topology(int cpu, const char* name, int fallback) {
+    const std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/" + name;
+    std::ifstream file(path);
+    int value;
+    return (file >> value) ? value : fallback;
+}
+
+// Helper: allowed CPUs in pinning order. Every physical core gets a thread
+// before any SMT sibling does, and consecutive threads alternate between
+// nodes so a run with fewer threads than CPUs still uses every node.
+static std::vector<int> ordered_cpus() {
+    std::vector<int> cpus;
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) != 0) return cpus;
+
+    struct Slot {
+        int cpu, node, core, sibling;
+        std::pair<int, int> id;  // (package, core_id) identifies a physical core
+    };
+    std::vector<Slot> slots;
+    for (int c = 0; c < CPU_SETSIZE; ++c) {
+        if (!CPU_ISSET(c, &mask)) continue;
+        Slot s = {c, 0, 0, 0, std::make_pair(read_topology(c, "physical_package_id", 0),
+                                             read_topology(c, "core_id", c))};
+#ifdef HAVE_LIBNUMA
+        if (Numa::libnuma_available()) s.node = std::max(0, numa_node_of_cpu(c));
+#endif
+        slots.push_back(s);
+    }
+
+    // sibling: index among the CPUs of one physical core (0 = first hardware thread)
+    // core: index of the physical core within its node
+    std::map<std::pair<int, int>, int> siblings;
+    std::map<int, std::map<std::pair<int, int>, int> > cores;
+    for (Slot& s : slots) {
+        s.sibling = siblings[s.id]++;
+        std::map<std::pair<int, int>, int>& node_cores = cores[s.node];
+        const int next = static_cast<int>(node_cores.size());
+        s.core = node_cores.insert(std::make_pair(s.id, next)).first->second;
+    }
+
+    // Order by (sibling, core within node, node)
+    std::stable_sort(slots.begin(), slots.end(), [](const Slot& a, const Slot& b) {
+        if (a.sibling != b.sibling) return a.sibling < b.sibling;
+        if (a.core != b.core) return a.core < b.core;
+        return a.node < b.node;
+    });
+    for (const Slot& s : slots) cpus.push_back(s.cpu);
+    return cpus;
+}
+
+void Numa::pin_threads() {
+    // Respect an explicit OpenMP binding or QR_PIN=0
+    const char* bind = std::getenv("OMP_PROC_BIND");
+    const char* pin = std::getenv("QR_PIN");
+    if ((bind != nullptr && *bind != '\0') || (pin != nullptr && std::strcmp(pin, "0") == 0))
+        return;
+
+    static const std::vector<int> cpus = ordered_cpus();
+    if (cpus.empty()) return;
+
+    #pragma omp parallel
+    {
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        CPU_SET(cpus[thread_id() % cpus.size()], &mask);
+        pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask);
+    }
+}
+
+void Numa::report(std::ostream& os) {
+    static const char* names[] = {"serial", "firsttouch", "interleave", "bind"};
+    const NumaPolicy active = policy();  // May print a QR_NUMA warning first
+    os << "NUMA: " << node_count() << " node(s), libnuma "
+       << (libnuma_available() ? "available" : "unavailable")
+       << ", policy " << names[static_cast<int>(active)];
+    if (active == NumaPolicy::Bind) os << ":" << bind_node();
+    os << ", " << max_threads() << " thread(s) (set with QR_NUMA, QR_PIN, OMP_NUM_THREADS)\n";
+}
@@ -1,16 +1,47 @@
 #include "qr_householder.h"
+#include "kernels.h"
 #include <cmath>
 #include <vector>
 #include <iostream>
+#include <algorithm>
 
 // Helper: Infinity norm of vector
 static double vector_norm_inf(const std::vector<double>& v) {
-    double max = 0.0;
-    for (double x : v) {
-        double abs_val = std::fabs(x);
-        if (abs_val > max) max = abs_val;
+    return Kernels::get().max_abs(v.data(), v.size());
+}
+
+bool HouseholderQR::make_householder(
+    const Matrix& R,
+    int k,
+    std::vector<double>& v,
+    double& beta,
+    double& sigma
+) {
+    const int m = R.rows();
+
+    // Extract column k from diagonal downward
+    std::vector<double> x;
+    for (int i = k; i < m; ++i) {
+        x.push_back(R(i, k));
     }
-    return max;
+
+    if (vector_norm_inf(x) < 1e-12) return false;
+
+    // Compute norm and sign
+    const KernelTable& kern = Kernels::get();
+    const double norm_x = std::sqrt(kern.dot(x.data(), x.data(), x.size()));
+    
+    const double sign = (x[0] >= 0) ? 1.0 : -1.0;
+    sigma = -sign * norm_x;
+    
+    // Construct Householder vector
+    v = x;
+    v[0] = x[0] - sigma;  // v = x - sigma*e1
+    
+    // Compute beta = 2/(v^T v)
+    const double vtv = kern.dot(v.data(), v.data(), v.size());
+    beta = 2.0 / vtv;
+    return true;
 }
 
 QRResult HouseholderQR::decompose(const Matrix& A) {
@@ -21,32 +52,11 @@ QRResult HouseholderQR::decompose(const Matrix& A) {
     Matrix Q = Matrix::identity(m);
     Matrix R = A;
 
+    std::vector<double> v;
+    double beta, sigma;
     for (int k = 0; k < t; ++k) {
-        // Extract column k from diagonal downward
-        std::vector<double> x;
-        for (int i = k; i < m; ++i) {
-            x.push_back(R(i, k));
-        }
-
         // Skip if zero column
-        if (vector_norm_inf(x) < 1e-12) continue;
-
-        // Compute norm and sign
-        double norm_x = 0.0;
-        for (double val : x) norm_x += val * val;
-        norm_x = std::sqrt(norm_x);
-        
-        const double sign = (x[0] >= 0) ? 1.0 : -1.0;
-        const double sigma = -sign * norm_x;
-        
-        // Construct Householder vector
-        std::vector<double> v = x;
-        v[0] = x[0] - sigma;  // v = x - sigma*e1
-        
-        // Compute beta = 2/(v^T v)
-        double vtv = 0.0;
-        for (double val : v) vtv += val * val;
-        const double beta = 2.0 / vtv;
+        if (!make_householder(R, k, v, beta, sigma)) continue;
 
         // Apply transformation to R and Q
         apply_householder(R, Q, v, beta, k);
@@ -71,35 +81,147 @@ void HouseholderQR::apply_householder(
     double beta, 
     int k
 ) {
-    const int m = R.rows();
-    const int n = R.cols();
+    const int m = Q.rows();
     const int v_size = v.size();
+    const KernelTable& kern = Kernels::get();
     
     // Apply to R: R = (I - beta*v*v^T) * R
-    for (int j = k; j < n; ++j) {
-        // Compute v^T * R_col
-        double dot = 0.0;
-        for (int i = 0; i < v_size; ++i) {
-            dot += v[i] * R(k + i, j);
-        }
-        
-        // Update column
-        for (int i = 0; i < v_size; ++i) {
-            R(k + i, j) -= beta * dot * v[i];
-        }
-    }
+    apply_householder_left(R, v, beta, k, k);
     
-    // Apply to Q: Q = Q * (I - beta*v*v^T)
+    // Apply to Q: Q = Q * (I - beta*v*v^T), row by row
+    double* q = Q.data();
     for (int i = 0; i < m; ++i) {
-        // Compute Q_row * v
-        double dot = 0.0;
-        for (int j = 0; j < v_size; ++j) {
-            dot += Q(i, k + j) * v[j];
+        double* row = q + static_cast<size_t>(i) * m + k;
+        const double dot = kern.dot(row, v.data(), v_size);
+        kern.axpy(v_size, -beta * dot, v.data(), row);
+    }
+}
+
+void HouseholderQR::apply_householder_left(
+    Matrix& M,
+    const std::vector<double>& v,
+    double beta,
+    int k,
+    int col_begin
+) {
+    const int n = M.cols();
+    const int v_size = v.size();
+    const int width = n - col_begin;
+    if (width <= 0) return;
+
+    double* base = M.data() + static_cast<size_t>(k) * n + col_begin;
+
+    const KernelTable& kern = Kernels::get();
+
+    // w = v^T * M(k:, col_begin:), accumulated row by row for contiguous access
+    std::vector<double> w(width, 0.0);
+    kern.row_gemm(v_size, width, 1.0, v.data(), base, n, w.data());
+
+    // M(k:, col_begin:) -= beta * v * w^T
+    for (int i = 0; i < v_size; ++i) {
+        double* row = base + static_cast<size_t>(i) * n;
+        kern.axpy(width, -beta * v[i], w.data(), row);
+    }
+}
+
+Matrix HouseholderQR::accumulate_q(
+    int m,
+    int t,
+    const std::vector<std::vector<double>>& vs,
+    const std::vector<double>& betas
+) {
+    // Q = H_0 H_1 ... H_{t-1} * I(:, 0:t), applied backward so that H_k
+    // only touches columns k.. of the partial product
+    Matrix Q(m, t, 0.0);
+    for (int i = 0; i < t; ++i) Q(i, i) = 1.0;
+
+    for (int k = t - 1; k >= 0; --k) {
+        if (vs[k].empty()) continue;
+        apply_householder_left(Q, vs[k], betas[k], k, k);
+    }
+    return Q;
+}
+
+QRResult HouseholderQR::decompose_economy(const Matrix& A) {
+    const int m = A.rows();
+    const int n = A.cols();
+    const int t = std::min(m, n);
+
+    Matrix R = A;
+    std::vector<std::vector<double>> vs(t);
+    std::vector<double> betas(t, 0.0);
+
+    double sigma;
+    for (int k = 0; k < t; ++k) {
+        if (!make_householder(R, k, vs[k], betas[k], sigma)) {
+            vs[k].clear();
+            continue;
         }
-        
-        // Update row
-        for (int j = 0; j < v_size; ++j) {
-            Q(i, k + j) -= beta * dot * v[j];
+        apply_householder_left(R, vs[k], betas[k], k, k);
+        R(k, k) = sigma;
+        for (int i = k + 1; i < m; ++i) R(i, k) = 0.0;
+    }
+
+    // Keep the upper t rows of R
+    Matrix R_thin(t, n, 0.0);
+    std::copy(R.data(), R.data() + static_cast<size_t>(t) * n, R_thin.data());
+
+    return QRResult(accumulate_q(m, t, vs, betas), R_thin);
+}
+
+QRResult HouseholderQR::decompose_pivoted(const Matrix& A, std::vector<int>& perm) {
+    const int m = A.rows();
+    const int n = A.cols();
+    const int t = std::min(m, n);
+
+    Matrix R = A;
+    std::vector<std::vector<double>> vs(t);
+    std::vector<double> betas(t, 0.0);
+
+    // Squared column norms, downdated after every step
+    perm.resize(n);
+    std::vector<double> norms(n, 0.0), norms_ref(n);
+    for (int j = 0; j < n; ++j) perm[j] = j;
+    for (int i = 0; i < m; ++i)
+        for (int j = 0; j < n; ++j)
+            norms[j] += R(i, j) * R(i, j);
+    norms_ref = norms;
+
+    double sigma;
+    for (int k = 0; k < t; ++k) {
+        // Bring the column with the largest remaining norm to position k
+        int p = k;
+        for (int j = k + 1; j < n; ++j)
+            if (norms[j] > norms[p]) p = j;
+        if (p != k) {
+            for (int i = 0; i < m; ++i) std::swap(R(i, k), R(i, p));
+            std::swap(perm[k], perm[p]);
+            std::swap(norms[k], norms[p]);
+            std::swap(norms_ref[k], norms_ref[p]);
+        }
+
+        if (!make_householder(R, k, vs[k], betas[k], sigma)) {
+            vs[k].clear();
+            continue;
+        }
+        apply_householder_left(R, vs[k], betas[k], k, k);
+        R(k, k) = sigma;
+        for (int i = k + 1; i < m; ++i) R(i, k) = 0.0;
+
+        for (int j = k + 1; j < n; ++j) {
+            norms[j] -= R(k, j) * R(k, j);
+
+            // Recompute when downdating has cancelled most of the norm
+            if (norms[j] < 1e-10 * norms_ref[j]) {
+                double sum = 0.0;
+                for (int i = k + 1; i < m; ++i) sum += R(i, j) * R(i, j);
+                norms[j] = norms_ref[j] = sum;
+            }
         }
     }
-}
\ No newline at end of file
+
+    Matrix R_thin(t, n, 0.0);
+    std::copy(R.data(), R.data() + static_cast<size_t>(t) * n, R_thin.data());
+
+    return QRResult(accumulate_q(m, t, vs, betas), R_thin);
+}
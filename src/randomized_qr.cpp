@@ -0,0 +1,425 @@
+#include "randomized_qr.h"
+#include "qr_householder.h"
+#include "matrix_generator.h"
+#include "kernels.h"
+#include <cmath>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+// Helper: C = A * B, parallel over rows of A
+static Matrix multiply(const Matrix& A, const Matrix& B) {
+    if (A.cols() != B.rows())
+        throw std::invalid_argument("Matrix dimensions mismatch in multiply");
+
+    const int m = A.rows();
+    const int n = A.cols();
+    const int l = B.cols();
+    Matrix C(m, l, 0.0);
+    const double* a = A.data();
+    const double* b = B.data();
+    double* c = C.data();
+    const KernelTable& kern = Kernels::get();
+
+    #pragma omp parallel for schedule(static, Numa::tile_rows)
+    for (int i = 0; i < m; ++i) {
+        kern.row_gemm(n, l, 1.0, a + static_cast<size_t>(i) * n, b, l,
+                      c + static_cast<size_t>(i) * l);
+    }
+    return C;
+}
+
+// Helper: C = Aᵀ * B without forming Aᵀ, parallel over row blocks of C
+static Matrix multiply_transposed(const Matrix& A, const Matrix& B) {
+    if (A.rows() != B.rows())
+        throw std::invalid_argument("Matrix dimensions mismatch in multiply_transposed");
+
+    const int m = A.rows();
+    const int n = A.cols();
+    const int l = B.cols();
+    const int block = Numa::tile_rows;
+    const int num_blocks = (n + block - 1) / block;
+    Matrix C(n, l, 0.0);
+    const double* a = A.data();
+    const double* b = B.data();
+    double* c = C.data();
+    const KernelTable& kern = Kernels::get();
+
+    // Each block owns rows [j0, j1) of C, so no reduction is needed;
+    // block jb is tile jb of C, so it runs on the thread that placed it
+    #pragma omp parallel for schedule(static, 1)
+    for (int jb = 0; jb < num_blocks; ++jb) {
+        const int j0 = jb * block;
+        const int j1 = std::min(n, j0 + block);
+        for (int i = 0; i < m; ++i) {
+            const double* a_row = a + static_cast<size_t>(i) * n;
+            const double* b_row = b + static_cast<size_t>(i) * l;
+            for (int j = j0; j < j1; ++j)
+                kern.axpy(l, a_row[j], b_row, c + static_cast<size_t>(j) * l);
+        }
+    }
+    return C;
+}
+
+// Helper: C = Qᵀ * A for a thin Q (m×l, l ≪ n), computed as (AᵀQ)ᵀ so the
+// parallel loop runs over the n/64 row blocks of AᵀQ instead of the l/64 of QᵀA
+static Matrix multiply_transposed_thin(const Matrix& Q, const Matrix& A) {
+    return multiply_transposed(A, Q).transpose();
+}
+
+// Helper: orthonormal basis of range(Y) via economy Householder QR
+static Matrix orthonormalize(const Matrix& Y) {
+    return HouseholderQR::decompose_economy(Y).Q;
+}
+
+// Helper: largest column 2-norm of X
+static double max_column_norm(const Matrix& X) {
+    const int m = X.rows();
+    const int r = X.cols();
+    std::vector<double> norms(r, 0.0);
+    for (int i = 0; i < m; ++i)
+        for (int j = 0; j < r; ++j)
+            norms[j] += X(i, j) * X(i, j);
+    return std::sqrt(*std::max_element(norms.begin(), norms.end()));
+}
+
+// Helper: orthonormal basis Q of the numerically significant part of range(Y);
+// returns its width r (Q is left untouched when r = 0). Pivoted QR sorts the
+// directions by size and the basis stops at the first |R(j, j)| <= drop, which
+// also cuts off reflectors decompose_pivoted skipped (they come back as e_k).
+static int orthonormalize_truncated(const Matrix& Y, double drop, Matrix& Q) {
+    const int m = Y.rows();
+    const int b = Y.cols();
+    const double scale = max_column_norm(Y);
+    if (scale <= drop) return 0;
+
+    // Unit scale, so a skipped reflector (|R(k, k)| < 1e-12) always fails the test
+    Matrix S = Y;
+    double* s = S.data();
+    const size_t size = static_cast<size_t>(m) * b;
+    for (size_t i = 0; i < size; ++i) s[i] /= scale;
+
+    std::vector<int> perm;
+    QRResult qr = HouseholderQR::decompose_pivoted(S, perm);
+    const double cutoff = std::max(drop / scale, 1e-12);
+    int r = 0;
+    while (r < qr.R.rows() && std::fabs(qr.R(r, r)) > cutoff) ++r;
+    if (r == 0) return 0;
+
+    Q = Matrix(m, r);
+    for (int i = 0; i < m; ++i)
+        for (int j = 0; j < r; ++j)
+            Q(i, j) = qr.Q(i, j);
+    return r;
+}
+
+// Helper: Y = Y - P for matrices of equal size
+static void subtract(Matrix& Y, const Matrix& P) {
+    double* y = Y.data();
+    const double* p = P.data();
+    const size_t size = static_cast<size_t>(Y.rows()) * Y.cols();
+    for (size_t i = 0; i < size; ++i) y[i] -= p[i];
+}
+
+// Helper: Y = Y - Q (Qᵀ Y)
+static void project_out(const Matrix& Q, Matrix& Y) {
+    subtract(Y, multiply(Q, multiply_transposed(Q, Y)));
+}
+
+// Helper: [L R] side by side
+static Matrix hstack(const Matrix& L, const Matrix& R) {
+    const int m = L.rows();
+    const int a = L.cols();
+    const int b = R.cols();
+    Matrix S(m, a + b);
+    for (int i = 0; i < m; ++i) {
+        std::copy(L.data() + static_cast<size_t>(i) * a,
+                  L.data() + static_cast<size_t>(i + 1) * a,
+                  S.data() + static_cast<size_t>(i) * (a + b));
+        std::copy(R.data() + static_cast<size_t>(i) * b,
+                  R.data() + static_cast<size_t>(i + 1) * b,
+                  S.data() + static_cast<size_t>(i) * (a + b) + a);
+    }
+    return S;
+}
+
+// Helper: [T; U] stacked vertically
+static Matrix vstack(const Matrix& T, const Matrix& U) {
+    const int n = T.cols();
+    Matrix S(T.rows() + U.rows(), n);
+    const size_t top = static_cast<size_t>(T.rows()) * n;
+    std::copy(T.data(), T.data() + top, S.data());
+    std::copy(U.data(), U.data() + static_cast<size_t>(U.rows()) * n, S.data() + top);
+    return S;
+}
+
+// Seed salts: sketches use seed + step, so probe matrices need keys far from
+// that range to stay independent of the basis they are testing
+static const unsigned long long kAdaptiveProbeSalt = 0x9E3779B97F4A7C15ULL;
+static const unsigned long long kEstimateProbeSalt = 0xD1B54A32D192ED03ULL;
+
+// Adaptive mode stops once the residual sample is below this fraction of ||A||
+static const double kDeflationTol = 1e3 * std::numeric_limits<double>::epsilon();
+
+// Helper: rows×cols matrix of i.i.d. N(0, 1) entries, reproducible for a seed
+static Matrix gaussian(int rows, int cols, unsigned long long seed) {
+    return MatrixGenerator::gaussian(rows, cols, seed);
+}
+
+// Helper: 10·sqrt(2/π)·max column 2-norm of (X - Y)
+static double probe_bound(const Matrix& X, const Matrix& Y) {
+    const int m = X.rows();
+    const int r = X.cols();
+    std::vector<double> norms(r, 0.0);
+    for (int i = 0; i < m; ++i) {
+        for (int j = 0; j < r; ++j) {
+            const size_t idx = static_cast<size_t>(i) * r + j;
+            const double d = X.data()[idx] - Y.data()[idx];
+            norms[j] += d * d;
+        }
+    }
+    const double max_norm = std::sqrt(*std::max_element(norms.begin(), norms.end()));
+    const double pi = 3.14159265358979323846;
+    return 10.0 * std::sqrt(2.0 / pi) * max_norm;
+}
+
+// Helper: in-place fast Walsh-Hadamard transform, size must be a power of two
+static void fwht(std::vector<double>& x) {
+    const size_t n = x.size();
+    for (size_t h = 1; h < n; h <<= 1) {
+        for (size_t i = 0; i < n; i += h << 1) {
+            for (size_t j = i; j < i + h; ++j) {
+                const double u = x[j];
+                const double v = x[j + h];
+                x[j] = u + v;
+                x[j + h] = u - v;
+            }
+        }
+    }
+}
+
+Matrix RandomizedQR::sketch(const Matrix& A, int l, const RandomizedQROptions& opts,
+                            unsigned long long seed) {
+    const int m = A.rows();
+    const int n = A.cols();
+
+    if (opts.sketch == SketchType::Gaussian) {
+        return multiply(A, gaussian(n, l, seed));
+    }
+
+    std::mt19937_64 gen(seed);
+    Matrix Y(m, l, 0.0);
+    const double* a = A.data();
+    double* y = Y.data();
+
+    if (opts.sketch == SketchType::SparseSign) {
+        // Each row of Ω holds s entries ±1/sqrt(s) in distinct random columns
+        const int s = std::max(1, std::min(opts.sparse_nnz, l));
+        const double scale = 1.0 / std::sqrt(static_cast<double>(s));
+        std::vector<int> cols(static_cast<size_t>(n) * s);
+        std::vector<double> vals(static_cast<size_t>(n) * s);
+        std::vector<int> pool(l);
+        for (int k = 0; k < l; ++k) pool[k] = k;
+
+        for (int j = 0; j < n; ++j) {
+            // Partial Fisher-Yates shuffle picks s distinct columns
+            for (int e = 0; e < s; ++e) {
+                std::uniform_int_distribution<int> pick(e, l - 1);
+                std::swap(pool[e], pool[pick(gen)]);
+                cols[static_cast<size_t>(j) * s + e] = pool[e];
+                vals[static_cast<size_t>(j) * s + e] = (gen() & 1) ? scale : -scale;
+            }
+        }
+
+        #pragma omp parallel for schedule(static, Numa::tile_rows)
+        for (int i = 0; i < m; ++i) {
+            const double* a_row = a + static_cast<size_t>(i) * n;
+            double* y_row = y + static_cast<size_t>(i) * l;
+            for (int j = 0; j < n; ++j) {
+                const double tmp = a_row[j];
+                const size_t base = static_cast<size_t>(j) * s;
+                for (int e = 0; e < s; ++e) y_row[cols[base + e]] += tmp * vals[base + e];
+            }
+        }
+        return Y;
+    }
+
+    // SRHT: Ω = D H S / sqrt(l) with random signs D, Hadamard H and column sampling S
+    size_t padded = 1;
+    while (padded < static_cast<size_t>(n)) padded <<= 1;
+
+    std::vector<double> signs(n);
+    for (int j = 0; j < n; ++j) signs[j] = (gen() & 1) ? 1.0 : -1.0;
+
+    std::vector<size_t> samples(padded);
+    for (size_t k = 0; k < padded; ++k) samples[k] = k;
+    std::shuffle(samples.begin(), samples.end(), gen);
+    samples.resize(l);
+
+    const double scale = 1.0 / std::sqrt(static_cast<double>(l));
+
+    #pragma omp parallel
+    {
+        std::vector<double> buffer(padded);
+
+        #pragma omp for schedule(static, Numa::tile_rows)
+        for (int i = 0; i < m; ++i) {
+            const double* a_row = a + static_cast<size_t>(i) * n;
+            std::fill(buffer.begin(), buffer.end(), 0.0);
+            for (int j = 0; j < n; ++j) buffer[j] = signs[j] * a_row[j];
+            fwht(buffer);
+            double* y_row = y + static_cast<size_t>(i) * l;
+            for (int k = 0; k < l; ++k) y_row[k] = scale * buffer[samples[k]];
+        }
+    }
+    return Y;
+}
+
+Matrix RandomizedQR::power_iterate(const Matrix& A, Matrix Y, int q) {
+    Matrix Q = orthonormalize(Y);
+    for (int it = 0; it < q; ++it) {
+        Matrix Z = orthonormalize(multiply_transposed(A, Q));
+        Q = orthonormalize(multiply(A, Z));
+    }
+    return Q;
+}
+
+Matrix RandomizedQR::range_fixed(const Matrix& A, int l, const RandomizedQROptions& opts) {
+    return power_iterate(A, sketch(A, l, opts, opts.seed), opts.power_iterations);
+}
+
+// Blocked randQB (Martinsson & Voronin): with B = QᵀA kept alongside Q, each
+// block samples and power-iterates on the residual A - QB, so it cannot
+// re-converge on directions Q already holds
+Matrix RandomizedQR::range_adaptive(const Matrix& A, const RandomizedQROptions& opts, Matrix& B) {
+    const int n = A.cols();
+    const int limit = std::min(A.rows(), n);
+    const int max_rank = opts.max_rank > 0 ? std::min(opts.max_rank, limit) : limit;
+    const int block = std::max(1, opts.block_size);
+    const int probes = std::max(1, opts.error_probes);
+
+    // Fixed probe set reused across steps keeps the estimate monotone
+    Matrix W = gaussian(n, probes, opts.seed ^ kAdaptiveProbeSalt);
+    Matrix AW = multiply(A, W);
+
+    // Residual directions below rounding level relative to ||A|| (||Aω||₂ ≈ ||A||_F)
+    // are noise: adding them would only break the orthogonality of Q
+    const double drop = kDeflationTol * max_column_norm(AW);
+
+    Matrix Q(1, 1);
+    int rank = 0;
+    for (int step = 0; rank < max_rank; ++step) {
+        const int b = std::min(block, max_rank - rank);
+
+        // Qi = orth((A - QB) Ω) = orth((I - QQᵀ) AΩ)
+        Matrix Y = sketch(A, b, opts, opts.seed + step);
+        if (rank > 0) project_out(Q, Y);
+        Matrix Qi(1, 1);
+        if (orthonormalize_truncated(Y, drop, Qi) == 0) break;  // A - QB is numerically zero
+
+        // Z = orth(AᵀQi - Bᵀ(QᵀQi)), Qi = orth(AZ - Q(BZ))
+        bool exhausted = false;
+        for (int it = 0; it < opts.power_iterations && !exhausted; ++it) {
+            Matrix Z = multiply_transposed(A, Qi);
+            if (rank > 0) subtract(Z, multiply_transposed(B, multiply_transposed(Q, Qi)));
+            exhausted = orthonormalize_truncated(Z, drop, Z) == 0;
+            if (exhausted) break;
+
+            Y = multiply(A, Z);
+            if (rank > 0) subtract(Y, multiply(Q, multiply(B, Z)));
+            exhausted = orthonormalize_truncated(Y, drop, Qi) == 0;
+        }
+        if (exhausted) break;
+
+        // Second Gram-Schmidt pass; a unit column that loses half its norm
+        // here was already in range(Q)
+        if (rank > 0) {
+            project_out(Q, Qi);
+            if (orthonormalize_truncated(Qi, 0.5, Qi) == 0) break;
+        }
+
+        Matrix Bi = multiply_transposed_thin(Qi, A);
+        Q = (rank > 0) ? hstack(Q, Qi) : Qi;
+        B = (rank > 0) ? vstack(B, Bi) : Bi;
+        rank = Q.cols();
+
+        if (probe_bound(AW, multiply(Q, multiply_transposed(Q, AW))) <= opts.tolerance)
+            break;
+    }
+    if (rank == 0) {
+        // A is numerically zero: any unit vector with B = 0 represents it
+        Q = Matrix(A.rows(), 1, 0.0);
+        Q(0, 0) = 1.0;
+        B = Matrix(1, n, 0.0);
+    }
+    return Q;
+}
+
+LowRankQRResult RandomizedQR::decompose(const Matrix& A, const RandomizedQROptions& opts) {
+    if (opts.rank <= 0 && opts.tolerance <= 0.0)
+        throw std::invalid_argument("RandomizedQR needs a target rank or a tolerance");
+    if (opts.oversampling < 0 || opts.power_iterations < 0)
+        throw std::invalid_argument("Invalid RandomizedQR options");
+
+    const int limit = std::min(A.rows(), A.cols());
+
+    // Orthonormal basis for the approximate range of A
+    // A ≈ Q B with B = Qᵀ A small (l×n); pivoted QR of B reveals the leading k columns
+    int k;
+    Matrix Q(1, 1);
+    Matrix B(1, 1);
+    if (opts.rank > 0) {
+        k = std::min(opts.rank, limit);
+        Q = range_fixed(A, std::min(k + opts.oversampling, limit), opts);
+        B = multiply_transposed_thin(Q, A);
+    } else {
+        Q = range_adaptive(A, opts, B);  // Builds B alongside Q
+        k = Q.cols();
+    }
+
+    std::vector<int> perm;
+    QRResult small = HouseholderQR::decompose_pivoted(B, perm);
+
+    // Truncate to rank k: Q_k = Q * Q_B(:, 0:k), R_k = R_B(0:k, :)
+    const int l = small.Q.cols();
+    const int n = A.cols();
+    Matrix QB_k(l, k);
+    for (int i = 0; i < l; ++i)
+        for (int j = 0; j < k; ++j)
+            QB_k(i, j) = small.Q(i, j);
+    Matrix R_k(k, n);
+    std::copy(small.R.data(), small.R.data() + static_cast<size_t>(k) * n, R_k.data());
+    Matrix Q_k = multiply(Q, QB_k);
+
+    const double err = estimate_error(A, Q_k, R_k, perm,
+                                      std::max(1, opts.error_probes),
+                                      opts.seed ^ kEstimateProbeSalt);
+    return LowRankQRResult(Q_k, R_k, perm, err);
+}
+
+double RandomizedQR::estimate_error(
+    const Matrix& A,
+    const Matrix& Q,
+    const Matrix& R,
+    const std::vector<int>& perm,
+    int probes,
+    unsigned long long seed
+) {
+    const int n = A.cols();
+    if (Q.rows() != A.rows() || R.cols() != n || Q.cols() != R.rows() ||
+        static_cast<int>(perm.size()) != n) {
+        throw std::invalid_argument("Matrix dimension mismatch in estimate_error");
+    }
+
+    // A(:, perm) Pᵀω = Aω, so compare Aω against QR (Pᵀω)
+    Matrix W = gaussian(n, probes, seed);
+    Matrix PtW(n, probes);
+    for (int j = 0; j < n; ++j)
+        std::copy(W.data() + static_cast<size_t>(perm[j]) * probes,
+                  W.data() + static_cast<size_t>(perm[j] + 1) * probes,
+                  PtW.data() + static_cast<size_t>(j) * probes);
+
+    return probe_bound(multiply(A, W), multiply(Q, multiply(R, PtW)));
+}